@@ -26,7 +26,16 @@
 #include <cstring>
 #include <iostream>
 #include <math.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/nowide/args.hpp>
 #include <boost/nowide/cstdlib.hpp>
@@ -52,6 +61,7 @@
 #include "libslic3r/Platform.hpp"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/SLAPrint.hpp"
+#include "libslic3r/SlicingService.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/Format/AMF.hpp"
 #include "libslic3r/Format/3mf.hpp"
@@ -63,6 +73,9 @@
 #include "libslic3r/BlacklistedLibraryCheck.hpp"
 #include "libslic3r/ProfilesSharingUtils.hpp"
 #include "libslic3r/Utils/DirectoriesUtils.hpp"
+#include "libslic3r/Utils/JsonUtils.hpp"
+
+#include <tbb/task_group.h>
 
 #include "PrusaSlicer.hpp"
 
@@ -78,6 +91,98 @@ static PrinterTechnology get_printer_technology(const DynamicConfig &config)
     return (opt == nullptr) ? ptUnknown : opt->value;
 }
 
+// A file name passed to --output containing placeholders is a template processed for each model the same way as output_filename_format.
+static bool is_output_template(const std::string &output)
+{
+    return boost::filesystem::path(output).filename().string().find_first_of("{[") != std::string::npos;
+}
+
+// Result of slicing and exporting one of the input models.
+struct SliceJob
+{
+    bool        finished    { false };
+    std::string input;
+    std::string output;
+    // Empty if the model was sliced and exported successfully.
+    std::string error;
+    // Duration of the job in seconds.
+    double      time        { 0. };
+    // Peak memory usage of the process at the end of the job in bytes.
+    // Jobs running concurrently share the memory of the process, thus it is an upper bound of the job's own peak.
+    size_t      peak_memory { 0 };
+};
+
+// Write the results of the finished slicing jobs into a JSON file to be processed by scripts.
+static bool write_batch_report(const std::string &path, const std::vector<SliceJob> &jobs)
+{
+    namespace pt = boost::property_tree;
+    pt::ptree jobs_node;
+    for (const SliceJob &job : jobs)
+        if (job.finished) {
+            pt::ptree job_node;
+            job_node.put("input", job.input);
+            job_node.put("output", job.output);
+            job_node.put("success", job.error.empty());
+            job_node.put("error", job.error);
+            job_node.put("time", job.time);
+            job_node.put("peak_memory", job.peak_memory);
+            jobs_node.push_back(std::make_pair("", job_node));
+        }
+    pt::ptree root;
+    root.add_child("jobs", jobs_node);
+
+    boost::nowide::ofstream file(path);
+    file << write_json_with_post_process(root);
+    file.close();
+    if (file.fail()) {
+        boost::nowide::cerr << "error: failed to write the batch report to " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+// Accept the connections on a local socket and answer the requests, one connection at a time:
+// the next client is accepted once the current one closes its connection.
+static int run_slicing_service(const std::string &socket_path, SlicingService &service)
+{
+    namespace asio = boost::asio;
+    using local = asio::local::stream_protocol;
+    try {
+        asio::io_context io_context;
+        // Only replace a socket left behind by a previous run of the service, never an unrelated file.
+        if (boost::filesystem::file_type type = boost::filesystem::status(socket_path).type(); type == boost::filesystem::socket_file)
+            boost::filesystem::remove(socket_path);
+        else if (type != boost::filesystem::file_not_found)
+            throw Slic3r::RuntimeError(socket_path + " exists and it is not a socket");
+        local::acceptor acceptor(io_context, local::endpoint(socket_path));
+        boost::nowide::cout << "Slicing service listening on " << socket_path << std::endl;
+        while (! service.shutdown_requested()) {
+            local::socket socket(io_context);
+            acceptor.accept(socket);
+            asio::streambuf           buffer;
+            boost::system::error_code ec;
+            while (! service.shutdown_requested() && asio::read_until(socket, buffer, '\n', ec) > 0) {
+                std::istream is(&buffer);
+                std::string  request;
+                std::getline(is, request);
+                if (boost::trim_copy(request).empty())
+                    continue;
+                std::string response = service.handle(request) + "\n";
+                asio::write(socket, asio::buffer(response), ec);
+                if (ec)
+                    break;
+            }
+        }
+        boost::filesystem::remove(socket_path);
+    } catch (const std::exception &ex) {
+        boost::nowide::cerr << "Slicing service failed: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
+
 int CLI::run(int argc, char **argv)
 {
     // Mark the main thread for the debugger and for runtime checks.
@@ -618,24 +723,41 @@ int CLI::run(int argc, char **argv)
             }
             // Make a copy of the model if the current action is not the last action, as the model may be
             // modified by the centering and such.
-            Model model_copy;
-            bool  make_copy = &opt_key != &m_actions.back();
-            for (Model &model_in : m_models) {
+            bool make_copy = &opt_key != &m_actions.back();
+            std::vector<SliceJob> jobs(m_models.size());
+            std::mutex            cout_mutex;
+            // Slice a single input model and export the result. An error is returned through job.error.
+            auto slice_model = [&](Model &model_in, SliceJob &job) {
+                Model model_copy;
                 if (make_copy)
                     model_copy = model_in;
                 Model &model = make_copy ? model_copy : model_in;
+                if (! model.objects.empty())
+                    job.input = model.objects.front()->input_file;
                 // If all objects have defined instances, their relative positions will be
                 // honored when printing (they will be only centered, unless --dont-arrange
                 // is supplied); if any object has no instances, it will get a default one
                 // and all instances will be rearranged (unless --dont-arrange is supplied).
                 std::string outfile = m_config.opt_string("output");
+                const DynamicPrintConfig *print_config = &m_print_config;
+                DynamicPrintConfig        template_config;
+                if (is_output_template(outfile)) {
+                    // Export into the directory of the template, the file name is generated from the template by output_filename_format.
+                    boost::filesystem::path path(outfile);
+                    template_config = m_print_config;
+                    template_config.set_key_value("output_filename_format", new ConfigOptionString(path.filename().string()));
+                    outfile       = (path.has_parent_path() ? path.parent_path() : boost::filesystem::current_path()).string();
+                    print_config  = &template_config;
+                }
                 Print       fff_print;
                 SLAPrint    sla_print;
                 sla_print.set_status_callback(
-                            [](const PrintBase::SlicingStatus& s)
+                            [&cout_mutex](const PrintBase::SlicingStatus& s)
                 {
-                    if(s.percent >= 0) // FIXME: is this sufficient?
+                    if(s.percent >= 0) { // FIXME: is this sufficient?
+                        std::lock_guard<std::mutex> lock(cout_mutex);
                         printf("%3d%s %s\n", s.percent, "% =>", s.text.c_str());
+                    }
                 });
 
                 PrintBase  *print = (printer_technology == ptFFF) ? static_cast<PrintBase*>(&fff_print) : static_cast<PrintBase*>(&sla_print);
@@ -650,41 +772,24 @@ int CLI::run(int argc, char **argv)
                     for (auto* mo : model.objects)
                         fff_print.auto_assign_extruders(mo);
                 }
-                print->apply(model, m_print_config);
+                print->apply(model, *print_config);
                 std::string err = print->validate();
                 if (! err.empty()) {
-                    boost::nowide::cerr << err << std::endl;
-                    return 1;
+                    job.error = std::move(err);
+                    return;
                 }
-                if (print->empty())
+                if (print->empty()) {
+                    std::lock_guard<std::mutex> lock(cout_mutex);
                     boost::nowide::cout << "Nothing to print for " << outfile << " . Either the print is empty or no object is fully inside the print volume." << std::endl;
-                else
+                } else
                     try {
-                        std::string outfile_final;
-                        print->process();
-                        if (printer_technology == ptFFF) {
-                            // The outfile is processed by a PlaceholderParser.
-                            outfile = fff_print.export_gcode(outfile, nullptr, nullptr);
-                            outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
-                        } else {
-                            outfile = sla_print.output_filepath(outfile);
-                            // We need to finalize the filename beforehand because the export function sets the filename inside the zip metadata
-                            outfile_final = sla_print.print_statistics().finalize_output_path(outfile);
-                            sla_print.export_print(outfile_final);
-                        }
-                        if (outfile != outfile_final) {
-                            if (Slic3r::rename_file(outfile, outfile_final)) {
-                                boost::nowide::cerr << "Renaming file " << outfile << " to " << outfile_final << " failed" << std::endl;
-                                return 1;
-                            }
-                            outfile = outfile_final;
-                        }
-                        // Run the post-processing scripts if defined.
-                        run_post_process_scripts(outfile, fff_print.full_print_config());
+                        outfile = process_and_export(printer_technology, fff_print, sla_print, outfile);
+                        job.output = outfile;
+                        std::lock_guard<std::mutex> lock(cout_mutex);
                         boost::nowide::cout << "Slicing result exported to " << outfile << std::endl;
                     } catch (const std::exception &ex) {
-                        boost::nowide::cerr << ex.what() << std::endl;
-                        return 1;
+                        job.error = ex.what();
+                        return;
                     }
 /*
                 print.center = ! m_config.has("center")
@@ -716,7 +821,72 @@ int CLI::run(int argc, char **argv)
                     << "Filament required: " << print.total_used_filament() << "mm"
                     << " (" << print.total_extruded_volume()/1000 << "cm3)" << std::endl;
 */
+            };
+            auto run_job = [&](size_t idx) {
+                auto t0 = std::chrono::steady_clock::now();
+                slice_model(m_models[idx], jobs[idx]);
+                jobs[idx].time        = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                jobs[idx].peak_memory = peak_memory_usage();
+                jobs[idx].finished    = true;
+            };
+
+            const size_t num_concurrent = std::min<size_t>(std::max(1, m_config.opt_int("batch_jobs")), m_models.size());
+            bool         failed         = false;
+            if (const std::string &output = m_config.opt_string("output"); is_output_template(output)) {
+                if (boost::filesystem::path dir = boost::filesystem::path(output).parent_path(); ! dir.empty() && ! boost::filesystem::is_directory(dir)) {
+                    boost::nowide::cerr << "error: the directory of the --output template " << output << " does not exist" << std::endl;
+                    return 1;
+                }
+            } else if (num_concurrent > 1 && ! output.empty() && ! boost::filesystem::is_directory(output)) {
+                // A file name passed to --output is used as is for all the models, the concurrent jobs would write into the same file.
+                boost::nowide::cerr << "error: --output has to be a directory or a file name template when slicing multiple models with --batch-jobs" << std::endl;
+                return 1;
             }
+            if (num_concurrent <= 1) {
+                for (size_t i = 0; i < m_models.size() && ! failed; ++ i) {
+                    run_job(i);
+                    if (! jobs[i].error.empty()) {
+                        boost::nowide::cerr << jobs[i].error << std::endl;
+                        failed = true;
+                    }
+                }
+            } else {
+                // Slice the models concurrently by a fixed number of jobs pulling the next model to slice.
+                // Each Print parallelizes internally on the same TBB arena, thus the jobs fill in the cores
+                // left idle by the serial parts of slicing a small model.
+                std::atomic<size_t> next_model { 0 };
+                tbb::task_group     task_group;
+                for (size_t i = 0; i < num_concurrent; ++ i)
+                    task_group.run([&]() {
+                        for (size_t idx = next_model ++; idx < m_models.size(); idx = next_model ++) {
+                            run_job(idx);
+                            if (! jobs[idx].error.empty()) {
+                                std::lock_guard<std::mutex> lock(cout_mutex);
+                                boost::nowide::cerr << jobs[idx].input << ": " << jobs[idx].error << std::endl;
+                            }
+                        }
+                    });
+                task_group.wait();
+                failed = std::any_of(jobs.begin(), jobs.end(), [](const SliceJob &job) { return ! job.error.empty(); });
+            }
+            if (const std::string &report = m_config.opt_string("batch_report"); ! report.empty() && ! write_batch_report(report, jobs))
+                failed = true;
+            if (failed)
+                return 1;
+        } else if (opt_key == "serve") {
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+            // The models are loaded by the requests, the transformations of the command line are not applied to them.
+            for (const std::string &transform : m_transforms)
+                if (transform != "dont_arrange" && transform != "ensure_on_bed") {
+                    boost::nowide::cerr << "error: --" << transform << " is not supported by the slicing service" << std::endl;
+                    return 1;
+                }
+            SlicingService service(m_print_config, printer_technology, ! m_config.opt_bool("dont_arrange"), m_config.opt_bool("ensure_on_bed"), bed, arrange_cfg);
+            return run_slicing_service(m_config.opt_string("serve"), service);
+#else
+            boost::nowide::cerr << "error: the slicing service is not supported on this platform" << std::endl;
+            return 1;
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
         } else {
             boost::nowide::cerr << "error: option not supported yet: " << opt_key << std::endl;
             return 1;
@@ -766,8 +766,8 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   if ((Closed && highI < 2) || (!Closed && highI < 1))
     return false;
 
-  // Allocate a new edge array.
-  Edges edges(highI + 1);
+  // Allocate a new edge array or reuse one released by Clear().
+  Edges edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
   if (result)
@@ -956,9 +956,30 @@ bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, b
 }
 //------------------------------------------------------------------------------
 
+ClipperBase::Edges ClipperBase::AllocateEdges(size_t num_edges)
+{
+  Edges edges;
+  if (! m_edges_free.empty()) {
+    edges = std::move(m_edges_free.back());
+    m_edges_free.pop_back();
+    m_edges_free_capacity -= edges.capacity();
+  }
+  // Value initialized the same way as a newly allocated edge array.
+  edges.resize(num_edges);
+  return edges;
+}
+//------------------------------------------------------------------------------
+
 void ClipperBase::Clear()
 {
   m_MinimaList.clear();
+  // Keep the edge arrays for the following AddPath() / AddPaths() calls, but don't hold too much memory.
+  for (Edges &edges : m_edges)
+    if (m_edges_free_capacity + edges.capacity() <= m_EdgesFreeMax) {
+      m_edges_free_capacity += edges.capacity();
+      edges.clear();
+      m_edges_free.emplace_back(std::move(edges));
+    }
   m_edges.clear();
 #ifndef CLIPPERLIB_INT32
   m_UseFullRange = false;
@@ -1042,6 +1063,7 @@ IntRect ClipperBase::GetBounds()
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
   m_OutPtsFree(nullptr),
+  m_OutPtsChunk(0),
   m_OutPtsChunkLast(m_OutPtsChunkSize),
   m_ActiveEdges(nullptr),
   m_SortedEdges(nullptr)
@@ -1059,8 +1081,12 @@ Clipper::Clipper(int initOptions) :
 void Clipper::Reset()
 {
   ClipperBase::Reset();
-  m_Scanbeam = std::priority_queue<cInt, cInts>{};
+  m_Scanbeam.clear();
   m_Maxima.clear();
+  // Left over by a previous Execute() interrupted by an exception.
+  m_Joins.clear();
+  m_GhostJoins.clear();
+  m_IntersectList.clear();
   m_ActiveEdges = 0;
   m_SortedEdges = 0;
   for (auto lm = m_MinimaList.rbegin(); lm != m_MinimaList.rend(); ++lm)
@@ -1173,21 +1199,25 @@ OutPt* Clipper::AllocateOutPt()
     pt = m_OutPtsFree;
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
-    // Get a point from the last chunk.
-    pt = &m_OutPts.back()[m_OutPtsChunkLast ++];
+    // Get a point from the current chunk.
+    pt = &m_OutPts[m_OutPtsChunk - 1][m_OutPtsChunkLast ++];
   } else {
-    // The last chunk is full. Allocate a new one.
-    m_OutPts.emplace_back();
+    // The current chunk is full. Take the next chunk kept from the previous Execute() or allocate a new one.
+    if (m_OutPtsChunk == m_OutPts.size())
+      m_OutPts.emplace_back();
     m_OutPtsChunkLast = 1;
-    pt = &m_OutPts.back().front();
+    pt = &m_OutPts[m_OutPtsChunk ++].front();
   }
   return pt;
 }
 
 void Clipper::DisposeAllOutRecs()
 {
-  m_OutPts.clear();
+  // Keep the chunks of output points for the next Execute(), but don't hold too much memory.
+  if (m_OutPts.size() > m_OutPtsChunksMax)
+    m_OutPts.resize(m_OutPtsChunksMax);
   m_OutPtsFree = nullptr;
+  m_OutPtsChunk = 0;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
   m_PolyOuts.clear();
 }
@@ -3361,8 +3391,12 @@ DoublePoint GetUnitNormal(const IntPoint &pt1, const IntPoint &pt2)
 
 void ClipperOffset::Clear()
 {
+  // Keep some of the nodes for the following AddPath() calls.
   for (int i = 0; i < m_polyNodes.ChildCount(); ++i)
-    delete m_polyNodes.Childs[i];
+    if (m_polyNodesFree.size() < m_PolyNodesFreeMax)
+      m_polyNodesFree.emplace_back(m_polyNodes.Childs[i]);
+    else
+      delete m_polyNodes.Childs[i];
   m_polyNodes.Childs.clear();
   m_lowest.x() = -1;
 }
@@ -3372,7 +3406,14 @@ void ClipperOffset::AddPath(const Path& path, JoinType joinType, EndType endType
 {
   int highI = (int)path.size() - 1;
   if (highI < 0) return;
-  PolyNode* newNode = new PolyNode();
+  PolyNode* newNode;
+  if (m_polyNodesFree.empty())
+    newNode = new PolyNode();
+  else {
+    newNode = m_polyNodesFree.back();
+    m_polyNodesFree.pop_back();
+    newNode->Contour.clear();
+  }
   newNode->m_jointype = joinType;
   newNode->m_endtype = endType;
 
@@ -3412,7 +3453,7 @@ void ClipperOffset::AddPath(const Path& path, JoinType joinType, EndType endType
   }
   if (endType == etClosedPolygon && j < 2)
   {
-    delete newNode;
+    m_polyNodesFree.emplace_back(newNode);
     return;
   }
   m_polyNodes.AddChild(*newNode);
@@ -3465,7 +3506,9 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3496,7 +3539,9 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -357,8 +357,8 @@ public:
     if (num_edges_total == 0)
       return false;
 
-    // Allocate a new edge array.
-    std::vector<TEdge, Allocator<TEdge>> edges(num_edges_total);
+    // Allocate a new edge array or reuse one released by Clear().
+    Edges edges = AllocateEdges(num_edges_total);
     // Fill in the edge array.
     bool result = false;
     TEdge *p_edge = edges.data();
@@ -392,6 +392,9 @@ protected:
   TEdge* ProcessBound(TEdge* E, bool IsClockwise);
   TEdge* DescendToMin(TEdge *&E);
   void AscendToMax(TEdge *&E, bool Appending, bool IsClosed);
+  // Allocate an array of num_edges value initialized edges, reusing an array released by Clear() if available.
+  using Edges = std::vector<TEdge, Allocator<TEdge>>;
+  Edges AllocateEdges(size_t num_edges);
 
   // Local minima (Y, left edge, right edge) sorted by ascending Y.
   std::vector<LocalMinimum, Allocator<LocalMinimum>> m_MinimaList;
@@ -405,8 +408,13 @@ protected:
 #endif // CLIPPERLIB_INT32
 
   // A vector of edges per each input path.
-  using Edges = std::vector<TEdge, Allocator<TEdge>>;
   std::vector<Edges, Allocator<Edges>> m_edges;
+  // Edge arrays released by Clear() to be reused by the following AddPath() / AddPaths() calls,
+  // so that a Clipper object used for many clipping operations does not reallocate its edges.
+  std::vector<Edges, Allocator<Edges>> m_edges_free;
+  // Sum of capacities of m_edges_free, limited by m_EdgesFreeMax.
+  size_t           m_edges_free_capacity { 0 };
+  static constexpr const size_t m_EdgesFreeMax = 16384;
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -456,7 +464,11 @@ private:
   std::deque<std::array<OutPt, m_OutPtsChunkSize>, Allocator<std::array<OutPt, m_OutPtsChunkSize>>> m_OutPts;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
+  // Index of the chunk of m_OutPts to take the points from. The chunks are kept by DisposeAllOutRecs()
+  // for the next Execute(), up to m_OutPtsChunksMax chunks.
+  size_t                m_OutPtsChunk;
   size_t                m_OutPtsChunkLast;
+  static constexpr const size_t m_OutPtsChunksMax = 512;
 
   std::vector<Join, Allocator<Join>>     m_Joins;
   std::vector<Join, Allocator<Join>>     m_GhostJoins;
@@ -464,7 +476,11 @@ private:
   ClipType              m_ClipType;
   // A priority queue (a binary heap) of Y coordinates.
   using cInts = std::vector<cInt, Allocator<cInt>>;
-  std::priority_queue<cInt, cInts> m_Scanbeam;
+  struct Scanbeam : public std::priority_queue<cInt, cInts> {
+    // Clear without releasing the memory of the underlying container.
+    void clear() { this->c.clear(); }
+  };
+  Scanbeam              m_Scanbeam;
   // Maxima are collected by ProcessEdgesAtTopOfScanbeam(), consumed by ProcessHorizontal().
   cInts                 m_Maxima;
   TEdge                *m_ActiveEdges;
@@ -540,7 +556,7 @@ class ClipperOffset
 public:
   ClipperOffset(double miterLimit = 2.0, double roundPrecision = 0.25, double shortestEdgeLength = 0.) :
     MiterLimit(miterLimit), ArcTolerance(roundPrecision), ShortestEdgeLength(shortestEdgeLength), m_lowest(-1, 0) {}
-  ~ClipperOffset() { Clear(); }
+  ~ClipperOffset() { Clear(); for (PolyNode *node : m_polyNodesFree) delete node; }
   void AddPath(const Path& path, JoinType joinType, EndType endType);
   template<typename PathsProvider>
   void AddPaths(PathsProvider &&paths, JoinType joinType, EndType endType) {
@@ -565,6 +581,11 @@ private:
   // y: index of the lowest point in the lowest contour
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Nodes released by Clear() to be reused by AddPath(), up to m_PolyNodesFreeMax nodes.
+  PolyNodes m_polyNodesFree;
+  static constexpr const size_t m_PolyNodesFreeMax = 256;
+  // Clipper cleaning up the offsetted paths, reused by the subsequent calls of Execute().
+  Clipper m_clipper;
 
   void FixOrientations();
   void DoOffset(double delta);
@@ -53,6 +53,15 @@ public:
                                                  m_tree, s, dir, hits, m_triangle_ray_epsilon);
     }
 
+    void intersect_rays(const indexed_triangle_set &its,
+                        const std::vector<Vec3d> &  s,
+                        const std::vector<Vec3d> &  dirs,
+                        std::vector<igl::Hit> &     hits)
+    {
+        AABBTreeIndirect::intersect_rays_first_hit(its.vertices, its.indices,
+                                                   m_tree, s, dirs, hits, m_triangle_ray_epsilon);
+    }
+
     double squared_distance(const indexed_triangle_set & its,
                             const Vec3d &                point,
                             int &                        i,
@@ -181,6 +190,42 @@ AABBMesh::query_ray_hit(const Vec3d &s, const Vec3d &dir) const
     return ret;
 }
 
+std::vector<AABBMesh::hit_result>
+AABBMesh::query_ray_hit(const std::vector<Vec3d> &s, const std::vector<Vec3d> &dir) const
+{
+    assert(s.size() == dir.size());
+    std::vector<AABBMesh::hit_result> outs;
+    outs.reserve(s.size());
+
+#ifdef SLIC3R_HOLE_RAYCASTER
+    if (! m_holes.empty()) {
+        // The holes are filtered ray by ray, see query_ray_hit(const Vec3d&, const Vec3d&).
+        for (size_t i = 0; i < s.size(); ++ i)
+            outs.emplace_back(query_ray_hit(s[i], dir[i]));
+        return outs;
+    }
+#endif
+
+    std::vector<igl::Hit> hits;
+    m_aabb->intersect_rays(*m_tm, s, dir, hits);
+
+    //  Convert the igl::Hit into hit_result
+    for (size_t i = 0; i < hits.size(); ++ i) {
+        assert(is_approx(dir[i].norm(), 1.));
+        const igl::Hit &hit = hits[i];
+        outs.emplace_back(AABBMesh::hit_result(*this));
+        outs.back().m_t = double(hit.t);
+        outs.back().m_dir = dir[i];
+        outs.back().m_source = s[i];
+        if(!std::isinf(hit.t) && !std::isnan(hit.t)) {
+            outs.back().m_normal = this->normal_by_face_id(hit.id);
+            outs.back().m_face_id = hit.id;
+        }
+    }
+
+    return outs;
+}
+
 std::vector<AABBMesh::hit_result>
 AABBMesh::query_ray_hits(const Vec3d &s, const Vec3d &dir) const
 {
@@ -120,6 +120,11 @@ public:
 
     // Casting a ray on the mesh, returns the distance where the hit occures.
     hit_result query_ray_hit(const Vec3d &s, const Vec3d &dir) const;
+
+    // Casting a batch of rays s[i] + t * dir[i] on the mesh, returns the closest hit of each ray.
+    // The rays are traversing the AABB tree together in small packets, thus
+    // the batch should be ordered so that the neighbor rays are coherent.
+    std::vector<hit_result> query_ray_hit(const std::vector<Vec3d> &s, const std::vector<Vec3d> &dir) const;
     
     // Casts a ray on the mesh and returns all hits
     std::vector<hit_result> query_ray_hits(const Vec3d &s, const Vec3d &dir) const;
@@ -278,17 +278,19 @@ namespace detail {
   		const Scalar 							&t1) {
 		// http://people.csail.mit.edu/amy/papers/box-jgt.pdf
 		// "An Efficient and Robust Ray–Box Intersection Algorithm"
+		// A ray parallel to a slab with its origin on one of the slab planes produces 0 * inf = NaN.
+		// Such a ray misses the box: the comparisons are written so that they reject NaNs.
 		if (inv_dir.x() < 0)
 			std::swap(box.min().x(), box.max().x());
 		if (inv_dir.y() < 0)
 			std::swap(box.min().y(), box.max().y());
         Scalar tmin = (box.min().x() - origin.x()) * inv_dir.x();
 		Scalar tymax = (box.max().y() - origin.y()) * inv_dir.y();
-		if (tmin > tymax)
+		if (! (tmin <= tymax))
 			return false;
         Scalar tmax = (box.max().x() - origin.x()) * inv_dir.x();
 		Scalar tymin = (box.min().y()  - origin.y()) * inv_dir.y();
-		if (tymin > tmax)
+		if (! (tymin <= tmax))
 			return false;
 		if (tymin > tmin)
 			tmin = tymin;
@@ -297,10 +299,10 @@ namespace detail {
 		if (inv_dir.z() < 0)
 			std::swap(box.min().z(), box.max().z());
 		Scalar tzmin = (box.min().z()  - origin.z()) * inv_dir.z();
-		if (tzmin > tmax)
+		if (! (tzmin <= tmax))
 			return false;
 		Scalar tzmax = (box.max().z() - origin.z()) * inv_dir.z();
-		if (tmin > tzmax)
+		if (! (tmin <= tzmax))
 			return false;
 		if (tzmin > tmin)
 			tmin = tzmin;
@@ -474,6 +476,147 @@ namespace detail {
 		}
 	}
 
+    // Number of rays traversing the AABB tree together, see intersect_rays_first_hit() and intersect_rays_all_hits().
+    // The ray / bounding box tests of a packet are evaluated with Eigen fixed size arrays, which Eigen maps
+    // to SSE2 / AVX registers if enabled by the compiler, falling back to scalar code otherwise.
+    static constexpr size_t RayPacketSize = 4;
+
+    // Packet of rays stored as a structure of arrays, one SIMD lane per ray.
+    template<typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+    struct RayPacketIntersector {
+        using Scalar = typename VectorType::Scalar;
+        using Lanes  = Eigen::Array<Scalar, RayPacketSize, 1>;
+        using Mask   = Eigen::Array<bool, RayPacketSize, 1>;
+
+        const std::vector<VertexType> 		&vertices;
+        const std::vector<IndexedFaceType> 	&faces;
+        const TreeType 						&tree;
+
+        // Origins and directions of all the rays of the batch.
+        const std::vector<VectorType>		&origins;
+        const std::vector<VectorType>		&dirs;
+
+        // epsilon for ray-triangle intersection, see intersect_triangle1()
+        const double  						 eps;
+
+        // Index of the ray of the first lane into origins / dirs.
+        size_t								 first_ray;
+        // Lanes not occupied by a ray at the end of the batch are masked out.
+        Mask								 active;
+        Lanes								 origin[3];
+        Lanes								 invdir[3];
+        // Parameter of the closest hit found so far, limiting the traversal of the first hit query.
+        Lanes								 t_max;
+
+        void load(size_t first_ray_idx) {
+            first_ray = first_ray_idx;
+            for (size_t i = 0; i < RayPacketSize; ++ i) {
+                // Duplicate the last ray into the unused lanes to keep the arithmetic of the unused lanes valid.
+                size_t ray_idx = std::min(first_ray + i, origins.size() - 1);
+                active[i] = first_ray + i < origins.size();
+                for (int axis = 0; axis < 3; ++ axis) {
+                    origin[axis][i] = origins[ray_idx][axis];
+                    invdir[axis][i] = Scalar(1) / dirs[ray_idx][axis];
+                }
+            }
+            t_max.setConstant(std::numeric_limits<Scalar>::infinity());
+        }
+    };
+
+    // Slab test of all the rays of a packet against a single bounding box.
+    // Returns mask of the rays of active_lanes, which intersect the box in the interval <0, t_max>,
+    // tmin_out receives the ray parameters of entering the box.
+    template<typename RayPacketIntersectorType, typename BoundingBoxType>
+    inline typename RayPacketIntersectorType::Mask ray_packet_box_intersect_invdir(
+        const RayPacketIntersectorType                  &ray_intersector,
+        const BoundingBoxType                           &box,
+        const typename RayPacketIntersectorType::Mask   &active_lanes,
+        typename RayPacketIntersectorType::Lanes        &tmin_out)
+    {
+        using Scalar = typename RayPacketIntersectorType::Scalar;
+        using Lanes  = typename RayPacketIntersectorType::Lanes;
+        using Mask   = typename RayPacketIntersectorType::Mask;
+        Lanes tmin  = Lanes::Zero();
+        Lanes tmax  = ray_intersector.t_max;
+        Mask  valid = active_lanes;
+        for (int axis = 0; axis < 3; ++ axis) {
+            Lanes t1 = (Scalar(box.min()[axis]) - ray_intersector.origin[axis]) * ray_intersector.invdir[axis];
+            Lanes t2 = (Scalar(box.max()[axis]) - ray_intersector.origin[axis]) * ray_intersector.invdir[axis];
+            // A ray parallel to the slab with its origin on a slab plane produces 0 * inf = NaN,
+            // which min() / max() would drop or keep depending on the order of the arguments.
+            // Reject such a ray the same way as ray_box_intersect_invdir() does.
+            valid = valid && (t1 == t1) && (t2 == t2);
+            tmin = tmin.max(t1.min(t2));
+            tmax = tmax.min(t1.max(t2));
+        }
+        tmin_out = tmin;
+        return valid && (tmin <= tmax);
+    }
+
+    // Traverse the AABB tree with a packet of rays, active_lanes being the rays intersecting the bounding box of node_idx.
+    // A subtree is skipped only if none of the rays of the packet intersects its bounding box, the leaf triangles
+    // are tested against each of the rays hitting the leaf box.
+    // on_hit(lane, hit) is called for each hit of a triangle with a positive ray parameter.
+    template<typename RayPacketIntersectorType, typename OnHit>
+    static inline void intersect_ray_packet_recursive(
+        RayPacketIntersectorType                      &ray_intersector,
+        size_t                                         node_idx,
+        typename RayPacketIntersectorType::Mask        active_lanes,
+        OnHit                                         &on_hit)
+    {
+        using Lanes = typename RayPacketIntersectorType::Lanes;
+        using Mask  = typename RayPacketIntersectorType::Mask;
+
+        const auto &node = ray_intersector.tree.node(node_idx);
+        assert(node.is_valid());
+
+        if (node.is_leaf()) {
+            auto face = ray_intersector.faces[node.idx];
+            for (size_t lane = 0; lane < RayPacketSize; ++ lane)
+                if (active_lanes[lane]) {
+                    size_t ray_idx = ray_intersector.first_ray + lane;
+                    double t, u, v;
+                    if (intersect_triangle(
+                            ray_intersector.origins[ray_idx], ray_intersector.dirs[ray_idx],
+                            ray_intersector.vertices[face(0)], ray_intersector.vertices[face(1)], ray_intersector.vertices[face(2)],
+                            t, u, v, ray_intersector.eps)
+                        && t > 0.)
+                        on_hit(lane, igl::Hit{ int(node.idx), -1, float(u), float(v), float(t) });
+                }
+        } else {
+            // Left / right child node index.
+            size_t left  = node_idx * 2 + 1;
+            size_t right = left + 1;
+            Lanes  left_tmin, right_tmin;
+            Mask   left_lanes  = ray_packet_box_intersect_invdir(ray_intersector, ray_intersector.tree.node(left).bbox,  active_lanes, left_tmin);
+            Mask   right_lanes = ray_packet_box_intersect_invdir(ray_intersector, ray_intersector.tree.node(right).bbox, active_lanes, right_tmin);
+            // Visit the child entered first by the majority of the rays first to shorten the rays early.
+            // The other child is then culled against the shortened rays.
+            Mask   both = left_lanes && right_lanes;
+            if (2 * (both && (right_tmin < left_tmin)).count() > both.count()) {
+                std::swap(left, right);
+                std::swap(left_lanes, right_lanes);
+                std::swap(left_tmin, right_tmin);
+            }
+            if (left_lanes.any())
+                intersect_ray_packet_recursive(ray_intersector, left, left_lanes, on_hit);
+            right_lanes = right_lanes && (right_tmin <= ray_intersector.t_max);
+            if (right_lanes.any())
+                intersect_ray_packet_recursive(ray_intersector, right, right_lanes, on_hit);
+        }
+    }
+
+    // Traverse the AABB tree with a packet of rays loaded into ray_intersector.
+    template<typename RayPacketIntersectorType, typename OnHit>
+    static inline void intersect_ray_packet(RayPacketIntersectorType &ray_intersector, OnHit &on_hit)
+    {
+        typename RayPacketIntersectorType::Lanes tmin;
+        typename RayPacketIntersectorType::Mask  active_lanes =
+            ray_packet_box_intersect_invdir(ray_intersector, ray_intersector.tree.node(0).bbox, ray_intersector.active, tmin);
+        if (active_lanes.any())
+            intersect_ray_packet_recursive(ray_intersector, size_t(0), active_lanes, on_hit);
+    }
+
     // Real-time collision detection, Ericson, Chapter 5
     template<typename Vector>
     static inline Vector closest_point_to_triangle(const Vector &p, const Vector &a, const Vector &b, const Vector &c)
@@ -791,6 +934,100 @@ inline bool intersect_ray_all_hits(
 	return ! hits.empty();
 }
 
+// Batched variant of intersect_ray_first_hit(): Find a first intersection of each of the rays origins[i] + t * dirs[i]
+// with indexed triangle set. The rays are traversing the AABB tree in packets of detail::RayPacketSize rays,
+// thus the batch should be ordered to keep the neighbor rays coherent (sharing an origin or pointing in a similar direction).
+// hits[i] receives the first hit of the i-th ray, hits[i].id == -1 and hits[i].t == infinity if the i-th ray misses.
+// Returns the number of rays intersecting the indexed triangle set.
+template<typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline size_t intersect_rays_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Origins of the rays.
+	const std::vector<VectorType>		&origins,
+	// Directions of the rays, one direction per origin.
+	const std::vector<VectorType>		&dirs,
+	// First intersections of the rays with the indexed triangle set.
+	std::vector<igl::Hit> 				&hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+	assert(origins.size() == dirs.size());
+	hits.assign(origins.size(), igl::Hit{ -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() });
+	if (tree.empty() || origins.empty())
+		return 0;
+
+	auto ray_intersector = detail::RayPacketIntersector<VertexType, IndexedFaceType, TreeType, VectorType> {
+		vertices, faces, tree, origins, dirs, eps
+	};
+	auto on_hit = [&ray_intersector, &hits](size_t lane, const igl::Hit &hit) {
+		igl::Hit &out = hits[ray_intersector.first_ray + lane];
+		// The child nodes are visited in the order of the rays, thus which one of equidistant hits is kept
+		// (ray hitting an edge shared by two triangles) may differ from intersect_ray_first_hit().
+		if (hit.t < out.t) {
+			out = hit;
+			ray_intersector.t_max[lane] = hit.t;
+		}
+	};
+	for (size_t first_ray = 0; first_ray < origins.size(); first_ray += detail::RayPacketSize) {
+		ray_intersector.load(first_ray);
+		detail::intersect_ray_packet(ray_intersector, on_hit);
+	}
+	return std::count_if(hits.begin(), hits.end(), [](const igl::Hit &hit) { return hit.id != -1; });
+}
+
+// Batched variant of intersect_ray_all_hits(): Find all intersections of each of the rays origins[i] + t * dirs[i]
+// with indexed triangle set, see intersect_rays_first_hit() for the traversal of the ray packets.
+// hits[i] receives the intersections of the i-th ray sorted by parameter t, possibly empty.
+// Returns the number of rays intersecting the indexed triangle set.
+template<typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline size_t intersect_rays_all_hits(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Origins of the rays.
+	const std::vector<VectorType>		&origins,
+	// Directions of the rays, one direction per origin.
+	const std::vector<VectorType>		&dirs,
+	// All intersections of each ray with the indexed triangle set, sorted by parameter t.
+	std::vector<std::vector<igl::Hit>> 	&hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+	assert(origins.size() == dirs.size());
+	// Reusing the output memory if there is some memory already pre-allocated.
+	hits.resize(origins.size());
+	for (std::vector<igl::Hit> &ray_hits : hits)
+		ray_hits.clear();
+	if (tree.empty() || origins.empty())
+		return 0;
+
+	auto ray_intersector = detail::RayPacketIntersector<VertexType, IndexedFaceType, TreeType, VectorType> {
+		vertices, faces, tree, origins, dirs, eps
+	};
+	auto on_hit = [&ray_intersector, &hits](size_t lane, const igl::Hit &hit) {
+		hits[ray_intersector.first_ray + lane].emplace_back(hit);
+	};
+	for (size_t first_ray = 0; first_ray < origins.size(); first_ray += detail::RayPacketSize) {
+		ray_intersector.load(first_ray);
+		detail::intersect_ray_packet(ray_intersector, on_hit);
+	}
+	size_t num_hit = 0;
+	for (std::vector<igl::Hit> &ray_hits : hits)
+		if (! ray_hits.empty()) {
+			std::sort(ray_hits.begin(), ray_hits.end(), [](const auto &l, const auto &r) { return l.t < r.t; });
+			++ num_hit;
+		}
+	return num_hit;
+}
+
 // Finding a closest triangle, its closest point and squared distance to the closest point
 // on a 3D indexed triangle set using a pre-built AABBTreeIndirect::Tree.
 // Closest point to triangle test will be performed with the accuracy of VectorType::Scalar
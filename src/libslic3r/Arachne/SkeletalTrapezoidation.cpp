@@ -61,7 +61,7 @@ static void export_graph_to_svg(const std::string
 
     if (transition_middles) {
         for (auto &edge : graph.edges) {
-            if (std::shared_ptr<std::list<SkeletalTrapezoidationEdge::TransitionMiddle>> transitions = edge.data.getTransitions(); transitions) {
+            if (std::shared_ptr<SkeletalTrapezoidationEdge::TransitionMiddles> transitions = edge.data.getTransitions(); transitions) {
                 for (auto &transition : *transitions) {
                     Line edge_line = Line(edge.to->p, edge.from->p);
                     double edge_length = edge_line.length();
@@ -75,7 +75,7 @@ static void export_graph_to_svg(const std::string
 
     if (transition_ends) {
         for (auto &edge : graph.edges) {
-            if (std::shared_ptr<std::list<SkeletalTrapezoidationEdge::TransitionEnd>> transitions = edge.data.getTransitionEnds(); transitions) {
+            if (std::shared_ptr<SkeletalTrapezoidationEdge::TransitionEnds> transitions = edge.data.getTransitionEnds(); transitions) {
                 for (auto &transition : *transitions) {
                     Line edge_line = Line(edge.to->p, edge.from->p);
                     double edge_length = edge_line.length();
@@ -780,7 +780,7 @@ void SkeletalTrapezoidation::generateTransitioningRibs()
 {
     // Store the upward edges to the transitions.
     // We only store the halfedge for which the distance_to_boundary is higher at the end than at the beginning.
-    ptr_vector_t<std::list<TransitionMiddle>> edge_transitions;
+    ptr_vector_t<TransitionMiddles> edge_transitions;
     generateTransitionMids(edge_transitions);
 
     for (edge_t& edge : graph.edges)
@@ -798,7 +798,7 @@ void SkeletalTrapezoidation::generateTransitioningRibs()
     export_graph_to_svg(debug_out_path("ST-generateTransitioningRibs-mids-%d.svg", iRun++), this->graph, this->outline);
 #endif
 
-    ptr_vector_t<std::list<TransitionEnd>> edge_transition_ends; // We only map the half edge in the upward direction. mapped items are not sorted
+    ptr_vector_t<TransitionEnds> edge_transition_ends; // We only map the half edge in the upward direction. mapped items are not sorted
     generateAllTransitionEnds(edge_transition_ends);
 
 #ifdef ARACHNE_DEBUG
@@ -814,7 +814,7 @@ void SkeletalTrapezoidation::generateTransitioningRibs()
 }
 
 
-void SkeletalTrapezoidation::generateTransitionMids(ptr_vector_t<std::list<TransitionMiddle>>& edge_transitions)
+void SkeletalTrapezoidation::generateTransitionMids(ptr_vector_t<TransitionMiddles>& edge_transitions)
 {
     for (edge_t& edge : graph.edges)
     {
@@ -884,7 +884,7 @@ void SkeletalTrapezoidation::generateTransitionMids(ptr_vector_t<std::list<Trans
             assert((! edge.data.hasTransitions(ignore_empty)) || mid_pos >= transitions->back().pos);
             if (! edge.data.hasTransitions(ignore_empty))
             {
-                edge_transitions.emplace_back(std::make_shared<std::list<TransitionMiddle>>());
+                edge_transitions.emplace_back(std::make_shared<TransitionMiddles>(graph.allocator<TransitionMiddle>()));
                 edge.data.setTransitions(edge_transitions.back());  // initialization
                 transitions = edge.data.getTransitions();
             }
@@ -1070,7 +1070,7 @@ bool SkeletalTrapezoidation::filterEndOfCentralTransition(edge_t* edge_to_start,
     return should_dissolve;
 }
 
-void SkeletalTrapezoidation::generateAllTransitionEnds(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+void SkeletalTrapezoidation::generateAllTransitionEnds(ptr_vector_t<TransitionEnds>& edge_transition_ends)
 {
     for (edge_t& edge : graph.edges)
     {
@@ -1090,7 +1090,7 @@ void SkeletalTrapezoidation::generateAllTransitionEnds(ptr_vector_t<std::list<Tr
     }
 }
 
-void SkeletalTrapezoidation::generateTransitionEnds(edge_t& edge, coord_t mid_pos, coord_t lower_bead_count, ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+void SkeletalTrapezoidation::generateTransitionEnds(edge_t& edge, coord_t mid_pos, coord_t lower_bead_count, ptr_vector_t<TransitionEnds>& edge_transition_ends)
 {
     const Point a = edge.from->p;
     const Point b = edge.to->p;
@@ -1127,7 +1127,7 @@ void SkeletalTrapezoidation::generateTransitionEnds(edge_t& edge, coord_t mid_po
     }
 }
 
-bool SkeletalTrapezoidation::generateTransitionEnd(edge_t& edge, coord_t start_pos, coord_t end_pos, coord_t transition_half_length, double start_rest, double end_rest, coord_t lower_bead_count, ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+bool SkeletalTrapezoidation::generateTransitionEnd(edge_t& edge, coord_t start_pos, coord_t end_pos, coord_t transition_half_length, double start_rest, double end_rest, coord_t lower_bead_count, ptr_vector_t<TransitionEnds>& edge_transition_ends)
 {
     Point a = edge.from->p;
     Point b = edge.to->p;
@@ -1212,7 +1212,7 @@ bool SkeletalTrapezoidation::generateTransitionEnd(edge_t& edge, coord_t start_p
         if(!upward_edge->data.hasTransitionEnds())
         {
             //This edge doesn't have a data structure yet for the transition ends. Make one.
-            edge_transition_ends.emplace_back(std::make_shared<std::list<TransitionEnd>>());
+            edge_transition_ends.emplace_back(std::make_shared<TransitionEnds>(graph.allocator<TransitionEnd>()));
             upward_edge->data.setTransitionEnds(edge_transition_ends.back());
         }
         auto transitions = upward_edge->data.getTransitionEnds();
@@ -1299,7 +1299,7 @@ static inline Point normal(const Point& p0, coord_t len)
     return (p0.cast<int64_t>() * int64_t(len) / _len).cast<coord_t>();
 };
 
-void SkeletalTrapezoidation::applyTransitions(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+void SkeletalTrapezoidation::applyTransitions(ptr_vector_t<TransitionEnds>& edge_transition_ends)
 {
     for (edge_t& edge : graph.edges)
     {
@@ -1309,7 +1309,7 @@ void SkeletalTrapezoidation::applyTransitions(ptr_vector_t<std::list<TransitionE
             auto& twin_transition_ends = *edge.twin->data.getTransitionEnds();
             if (! edge.data.hasTransitionEnds())
             {
-                edge_transition_ends.emplace_back(std::make_shared<std::list<TransitionEnd>>());
+                edge_transition_ends.emplace_back(std::make_shared<TransitionEnds>(graph.allocator<TransitionEnd>()));
                 edge.data.setTransitionEnds(edge_transition_ends.back());
             }
             auto& transition_ends = *edge.data.getTransitionEnds();
@@ -56,6 +56,8 @@ class SkeletalTrapezoidation
     using BeadingPropagation = SkeletalTrapezoidationJoint::BeadingPropagation;
     using TransitionMiddle = SkeletalTrapezoidationEdge::TransitionMiddle;
     using TransitionEnd = SkeletalTrapezoidationEdge::TransitionEnd;
+    using TransitionMiddles = SkeletalTrapezoidationEdge::TransitionMiddles;
+    using TransitionEnds = SkeletalTrapezoidationEdge::TransitionEnds;
 
     template<typename T>
     using ptr_vector_t = std::vector<std::shared_ptr<T>>;
@@ -138,8 +140,8 @@ protected:
     struct TransitionMidRef
     {
         edge_t* edge;
-        std::list<TransitionMiddle>::iterator transition_it;
-        TransitionMidRef(edge_t* edge, std::list<TransitionMiddle>::iterator transition_it)
+        TransitionMiddles::iterator transition_it;
+        TransitionMidRef(edge_t* edge, TransitionMiddles::iterator transition_it)
             : edge(edge)
             , transition_it(transition_it)
         {}
@@ -298,7 +300,7 @@ protected:
      * returned via the output parameter.
      * \param[out] edge_transitions A list of transitions that were generated.
      */
-    void generateTransitionMids(ptr_vector_t<std::list<TransitionMiddle>>& edge_transitions);
+    void generateTransitionMids(ptr_vector_t<TransitionMiddles>& edge_transitions);
 
     /*!
      * Removes some transition middle points.
@@ -352,12 +354,12 @@ protected:
      * Generate the endpoints of all transitions for all edges in the graph.
      * \param[out] edge_transition_ends The resulting transition endpoints.
      */
-    void generateAllTransitionEnds(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+    void generateAllTransitionEnds(ptr_vector_t<TransitionEnds>& edge_transition_ends);
 
     /*!
      * Also set the rest values at nodes in between the transition ends
      */
-    void applyTransitions(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+    void applyTransitions(ptr_vector_t<TransitionEnds>& edge_transition_ends);
 
     /*!
      * Create extra edges along all edges, where it needs to transition from one
@@ -380,7 +382,7 @@ protected:
      * \param[out] edge_transition_ends A list of endpoints to add the new
      * endpoints to.
      */
-    void generateTransitionEnds(edge_t& edge, coord_t mid_R, coord_t transition_lower_bead_count, ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+    void generateTransitionEnds(edge_t& edge, coord_t mid_R, coord_t transition_lower_bead_count, ptr_vector_t<TransitionEnds>& edge_transition_ends);
 
     /*!
      * Compute a single endpoint of a transition.
@@ -402,7 +404,7 @@ protected:
      * \return Whether the given edge is going downward (i.e. towards a thinner
      * region of the polygon).
      */
-    bool generateTransitionEnd(edge_t& edge, coord_t start_pos, coord_t end_pos, coord_t transition_half_length, double start_rest, double end_rest, coord_t transition_lower_bead_count, ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+    bool generateTransitionEnd(edge_t& edge, coord_t start_pos, coord_t end_pos, coord_t transition_half_length, double start_rest, double end_rest, coord_t transition_lower_bead_count, ptr_vector_t<TransitionEnds>& edge_transition_ends);
 
     /*!
      * Determines whether an edge is going downwards or upwards in the graph.
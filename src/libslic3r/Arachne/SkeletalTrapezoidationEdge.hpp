@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "utils/ExtrusionJunction.hpp"
+#include "utils/PoolAllocator.hpp"
 
 namespace Slic3r::Arachne
 {
@@ -46,6 +47,10 @@ public:
         {}
     };
 
+    // Transitions along an edge, allocated from the memory pool of the graph.
+    using TransitionMiddles = std::list<TransitionMiddle, PoolAllocator<TransitionMiddle>>;
+    using TransitionEnds    = std::list<TransitionEnd, PoolAllocator<TransitionEnd>>;
+
     enum class EdgeType
     {
         NORMAL = 0, // from voronoi diagram
@@ -75,11 +80,11 @@ public:
     {
         return transitions.use_count() > 0 && (ignore_empty || ! transitions.lock()->empty());
     }
-    void setTransitions(std::shared_ptr<std::list<TransitionMiddle>> storage)
+    void setTransitions(std::shared_ptr<TransitionMiddles> storage)
     {
         transitions = storage;
     }
-    std::shared_ptr<std::list<TransitionMiddle>> getTransitions()
+    std::shared_ptr<TransitionMiddles> getTransitions()
     {
         return transitions.lock();
     }
@@ -88,11 +93,11 @@ public:
     {
         return transition_ends.use_count() > 0 && (ignore_empty || ! transition_ends.lock()->empty());
     }
-    void setTransitionEnds(std::shared_ptr<std::list<TransitionEnd>> storage)
+    void setTransitionEnds(std::shared_ptr<TransitionEnds> storage)
     {
         transition_ends = storage;
     }
-    std::shared_ptr<std::list<TransitionEnd>> getTransitionEnds()
+    std::shared_ptr<TransitionEnds> getTransitionEnds()
     {
         return transition_ends.lock();
     }
@@ -113,8 +118,8 @@ public:
 private:
     Central is_central; //! whether the edge is significant; whether the source segments have a sharp angle; -1 is unknown
 
-    std::weak_ptr<std::list<TransitionMiddle>> transitions;
-    std::weak_ptr<std::list<TransitionEnd>> transition_ends;
+    std::weak_ptr<TransitionMiddles> transitions;
+    std::weak_ptr<TransitionEnds> transition_ends;
     std::weak_ptr<LineJunctions> extrusion_junctions;
 };
 
@@ -7,11 +7,13 @@
 
 #include <list>
 #include <cassert>
+#include <memory>
 
 
 
 #include "HalfEdge.hpp"
 #include "HalfEdgeNode.hpp"
+#include "PoolAllocator.hpp"
 
 namespace Slic3r::Arachne
 {
@@ -21,10 +23,21 @@ class HalfEdgeGraph
 public:
     using edge_t = derived_edge_t;
     using node_t = derived_node_t;
-    using Edges = std::list<edge_t>;
-    using Nodes = std::list<node_t>;
+    // Edges and nodes are allocated from a memory pool of the graph, so that they are not separate heap allocations.
+    using Edges = std::list<edge_t, PoolAllocator<edge_t>>;
+    using Nodes = std::list<node_t, PoolAllocator<node_t>>;
+
+    HalfEdgeGraph() : HalfEdgeGraph(std::make_shared<MemoryPool>()) {}
+
+    // Allocator for other data living as long as the graph, for example the transitions stored along the edges.
+    template<typename T>
+    PoolAllocator<T> allocator() const { return PoolAllocator<T>(edges.get_allocator()); }
+
     Edges edges;
     Nodes nodes;
+
+private:
+    explicit HalfEdgeGraph(const std::shared_ptr<MemoryPool> &pool) : edges(PoolAllocator<edge_t>(pool)), nodes(PoolAllocator<node_t>(pool)) {}
 };
 
 } // namespace Slic3r::Arachne
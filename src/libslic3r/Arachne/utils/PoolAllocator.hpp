@@ -0,0 +1,134 @@
+#ifndef UTILS_POOL_ALLOCATOR_H
+#define UTILS_POOL_ALLOCATOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Slic3r::Arachne
+{
+
+/*!
+ * Memory pool handing out small items of a fixed size from large blocks, so that the items
+ * created together are close to each other in memory and they are not separate heap allocations.
+ * Released items are recycled through a free list per item size, the blocks are only freed with the pool.
+ *
+ * The pool is not thread safe, it is meant to serve the data of a single SkeletalTrapezoidation,
+ * which is processed by a single thread.
+ */
+class MemoryPool
+{
+public:
+    MemoryPool() = default;
+    MemoryPool(const MemoryPool &) = delete;
+    MemoryPool &operator=(const MemoryPool &) = delete;
+
+    void *allocate(size_t size, size_t alignment)
+    {
+        assert(alignment <= alignof(std::max_align_t));
+        size = item_size(size);
+        if (size > MaxItemSize)
+            return ::operator new(size);
+        FreeList &free_list = this->free_list(size);
+        if (free_list.head != nullptr) {
+            FreeItem *item = free_list.head;
+            free_list.head = item->next;
+            return item;
+        }
+        if (size_t(m_block_end - m_block_ptr) < size) {
+            m_blocks.emplace_back(new std::max_align_t[BlockSize / sizeof(std::max_align_t)]);
+            m_block_ptr = reinterpret_cast<std::byte*>(m_blocks.back().get());
+            m_block_end = m_block_ptr + BlockSize;
+        }
+        void *out = m_block_ptr;
+        m_block_ptr += size;
+        return out;
+    }
+
+    void deallocate(void *ptr, size_t size) noexcept
+    {
+        size = item_size(size);
+        if (size > MaxItemSize) {
+            ::operator delete(ptr);
+            return;
+        }
+        FreeList &free_list = this->free_list(size);
+        free_list.head = ::new (ptr) FreeItem{ free_list.head };
+    }
+
+private:
+    static constexpr size_t BlockSize   = 64 * 1024;
+    static constexpr size_t MaxItemSize = 1024;
+
+    struct FreeItem
+    {
+        FreeItem *next;
+    };
+    struct FreeList
+    {
+        size_t    size;
+        FreeItem *head;
+    };
+
+    static size_t item_size(size_t size)
+    {
+        constexpr size_t alignment = alignof(std::max_align_t);
+        return std::max(sizeof(FreeItem), (size + alignment - 1) / alignment * alignment);
+    }
+
+    // Just a few item sizes are allocated, thus a linear search is fast enough.
+    FreeList &free_list(size_t size)
+    {
+        for (FreeList &free_list : m_free_lists)
+            if (free_list.size == size)
+                return free_list;
+        return m_free_lists.emplace_back(FreeList{ size, nullptr });
+    }
+
+    std::vector<std::unique_ptr<std::max_align_t[]>> m_blocks;
+    std::byte                                       *m_block_ptr { nullptr };
+    std::byte                                       *m_block_end { nullptr };
+    std::vector<FreeList>                            m_free_lists;
+};
+
+/*!
+ * Allocator of the std::list containers of a half edge graph, allocating the list nodes from a shared MemoryPool.
+ */
+template<typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    explicit PoolAllocator(std::shared_ptr<MemoryPool> pool) noexcept : m_pool(std::move(pool)) {}
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U> &rhs) noexcept : m_pool(rhs.m_pool) {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T*>(n == 1 ? m_pool->allocate(sizeof(T), alignof(T)) : ::operator new(n * sizeof(T)));
+    }
+    void deallocate(T *ptr, size_t n) noexcept
+    {
+        if (n == 1)
+            m_pool->deallocate(ptr, sizeof(T));
+        else
+            ::operator delete(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U> &rhs) const noexcept { return m_pool == rhs.m_pool; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U> &rhs) const noexcept { return m_pool != rhs.m_pool; }
+
+private:
+    template<typename U> friend class PoolAllocator;
+
+    std::shared_ptr<MemoryPool> m_pool;
+};
+
+} // namespace Slic3r::Arachne
+#endif // UTILS_POOL_ALLOCATOR_H
@@ -195,6 +195,53 @@ namespace ClipperUtils {
         out.erase(std::remove_if(out.begin(), out.end(), [](const Polygon &polygon) {return polygon.empty(); }), out.end());
         return out;
     }
+
+    // Engines not borrowed at the moment by the calling thread.
+    template<typename Engine>
+    static std::vector<std::unique_ptr<Engine>>& engine_pool()
+    {
+        static thread_local std::vector<std::unique_ptr<Engine>> pool;
+        return pool;
+    }
+
+    // Return the engine to its default state, keeping its buffers.
+    static void reset_engine(ClipperLib::Clipper &clipper)
+    {
+        clipper.Clear();
+        clipper.ReverseSolution(false);
+        clipper.StrictlySimple(false);
+        clipper.PreserveCollinear(false);
+    }
+    static void reset_engine(ClipperLib::ClipperOffset &co)
+    {
+        static const ClipperLib::ClipperOffset defaults;
+        co.Clear();
+        co.MiterLimit         = defaults.MiterLimit;
+        co.ArcTolerance       = defaults.ArcTolerance;
+        co.ShortestEdgeLength = defaults.ShortestEdgeLength;
+    }
+
+    template<typename Engine>
+    PooledEngine<Engine>::PooledEngine()
+    {
+        auto &pool = engine_pool<Engine>();
+        if (pool.empty())
+            m_engine = std::make_unique<Engine>();
+        else {
+            m_engine = std::move(pool.back());
+            pool.pop_back();
+        }
+    }
+
+    template<typename Engine>
+    PooledEngine<Engine>::~PooledEngine()
+    {
+        reset_engine(*m_engine);
+        engine_pool<Engine>().emplace_back(std::move(m_engine));
+    }
+
+    template class PooledEngine<ClipperLib::Clipper>;
+    template class PooledEngine<ClipperLib::ClipperOffset>;
 }
 
 static ExPolygons PolyTreeToExPolygons(ClipperLib::PolyTree &&polytree)
@@ -299,23 +346,23 @@ static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, Clipper
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::ClipperOffset co;
+    ClipperUtils::PooledClipperOffset co;
     ClipperLib::Paths out;
     out.reserve(paths.size());
     ClipperLib::Paths out_this;
     if (joinType == jtRound)
-        co.ArcTolerance = miterLimit;
+        co->ArcTolerance = miterLimit;
     else
-        co.MiterLimit = miterLimit;
-    co.ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
+        co->MiterLimit = miterLimit;
+    co->ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
     for (const ClipperLib::Path &path : paths) {
-        co.Clear();
+        co->Clear();
         // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
         // contours will be CCW oriented even though the input paths are CW oriented.
         // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-        co.AddPath(path, joinType, endType);
+        co->AddPath(path, joinType, endType);
         bool ccw = endType == ClipperLib::etClosedPolygon ? ClipperLib::Orientation(path) : true;
-        co.Execute(out_this, ccw ? offset : - offset);
+        co->Execute(out_this, ccw ? offset : - offset);
         if (! ccw) {
             // Reverse the resulting contours.
             for (ClipperLib::Path &path : out_this)
@@ -342,11 +389,11 @@ TResult clipper_do(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    ClipperUtils::PooledClipper clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    clipper->AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -373,10 +420,10 @@ TResult clipper_union(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    ClipperUtils::PooledClipper clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     TResult retval;
-    clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
+    clipper->Execute(ClipperLib::ctUnion, retval, fillType, fillType);
     return retval;
 }
 
@@ -416,12 +463,12 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
     assert(offset > 0);
     TResult out;
     if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
-        ClipperLib::Clipper clipper;
-        clipper.AddPaths(raw, ClipperLib::ptSubject, true);
-        ClipperLib::IntRect r = clipper.GetBounds();
-        clipper.AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
-        clipper.ReverseSolution(true);
-        clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
+        ClipperUtils::PooledClipper clipper;
+        clipper->AddPaths(raw, ClipperLib::ptSubject, true);
+        ClipperLib::IntRect r = clipper->GetBounds();
+        clipper->AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
+        clipper->ReverseSolution(true);
+        clipper->Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
         remove_outermost_polygon(out);
     }
     return out;
@@ -464,14 +511,14 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
-        ClipperLib::ClipperOffset co;
+        ClipperUtils::PooledClipperOffset co;
         if (joinType == jtRound)
-            co.ArcTolerance = miterLimit;
+            co->ArcTolerance = miterLimit;
         else
-            co.MiterLimit = miterLimit;
-        co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
-        co.AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
-        co.Execute(contours, delta);
+            co->MiterLimit = miterLimit;
+        co->ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+        co->AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
+        co->Execute(contours, delta);
     }
     if (contours.empty())
         // No need to try to offset the holes.
@@ -485,18 +532,18 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
         ClipperLib::Paths holes;
         {
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
+                ClipperUtils::PooledClipperOffset co;
                 if (joinType == jtRound)
-                    co.ArcTolerance = miterLimit;
+                    co->ArcTolerance = miterLimit;
                 else
-                    co.MiterLimit = miterLimit;
-                co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
-                co.AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
+                    co->MiterLimit = miterLimit;
+                co->ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+                co->AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
                 ClipperLib::Paths out2;
                 // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
                 // contours will be CCW oriented even though the input paths are CW oriented.
                 // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-                co.Execute(out2, - delta);
+                co->Execute(out2, - delta);
                 append(holes, std::move(out2));
             }
         }
@@ -821,11 +868,11 @@ Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subje
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
-    clipper.AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
+    ClipperUtils::PooledClipper clipper;
+    clipper->AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
+    clipper->AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
     ClipperLib::PolyTree retval;
-    clipper.Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    clipper->Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     return PolyTreeToPolylines(std::move(retval));
 }
 
@@ -1009,12 +1056,12 @@ Polygons simplify_polygons(const Polygons &subject)
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     ClipperLib::Paths output;
-    ClipperLib::Clipper c;
+    ClipperUtils::PooledClipper c;
 //    c.PreserveCollinear(true);
     //FIXME StrictlySimple is very expensive! Is it needed?
-    c.StrictlySimple(true);
-    c.AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
-    c.Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    c->StrictlySimple(true);
+    c->AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
+    c->Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 
     // convert into Slic3r polygons
     return to_polygons(std::move(output));
@@ -1025,12 +1072,12 @@ ExPolygons simplify_polygons_ex(const Polygons &subject, bool preserve_collinear
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     ClipperLib::PolyTree polytree;
-    ClipperLib::Clipper c;
+    ClipperUtils::PooledClipper c;
 //    c.PreserveCollinear(true);
     //FIXME StrictlySimple is very expensive! Is it needed?
-    c.StrictlySimple(true);
-    c.AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
-    c.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    c->StrictlySimple(true);
+    c->AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
+    c->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     
     // convert into ExPolygons
     return PolyTreeToExPolygons(std::move(polytree));
@@ -1041,12 +1088,12 @@ Polygons top_level_islands(const Slic3r::Polygons &polygons)
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperUtils::PooledClipper clipper;
+    clipper->Clear();
     // perform union
-    clipper.AddPaths(ClipperUtils::PolygonsProvider(polygons), ClipperLib::ptSubject, true);
+    clipper->AddPaths(ClipperUtils::PolygonsProvider(polygons), ClipperLib::ptSubject, true);
     ClipperLib::PolyTree polytree;
-    clipper.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
+    clipper->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
     // Convert only the top level islands to the output.
     Polygons out;
     out.reserve(polytree.ChildCount());
@@ -1067,10 +1114,10 @@ ClipperLib::Paths fix_after_outer_offset(
 
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-	  	clipper.AddPath(input, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+		ClipperUtils::PooledClipper clipper;
+	  	clipper->AddPath(input, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 	}
     return solution;
 }
@@ -1087,16 +1134,16 @@ ClipperLib::Paths fix_after_inner_offset(
 
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-		clipper.AddPath(input, ClipperLib::ptSubject, true);
-		ClipperLib::IntRect r = clipper.GetBounds();
+		ClipperUtils::PooledClipper clipper;
+		clipper->AddPath(input, ClipperLib::ptSubject, true);
+		ClipperLib::IntRect r = clipper->GetBounds();
 		r.left -= 10; r.top -= 10; r.right += 10; r.bottom += 10;
 		if (filltype == ClipperLib::pftPositive)
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
 		else
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 		if (! solution.empty())
 			solution.erase(solution.begin());
 	}
@@ -1292,13 +1339,13 @@ Polygons variable_offset_inner(const ExPolygon &expoly, const std::vector<std::v
 	if (holes.empty())
 		output = std::move(contours);
 	else {
-		ClipperLib::Clipper clipper;
-		clipper.Clear();
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
+		ClipperUtils::PooledClipper clipper;
+		clipper->Clear();
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
         // Holes may contain holes in holes produced by expanding a C hole shape.
         // The situation is processed correctly by Clipper diff operation.
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
-		clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
+		clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	}
 
 	return to_polygons(std::move(output));
@@ -1319,13 +1366,13 @@ ExPolygons variable_offset_inner_ex(const ExPolygon &expoly, const std::vector<s
         for (ClipperLib::Path &path : contours) 
             output.emplace_back(std::move(path));
     } else {
-        ClipperLib::Clipper clipper;
-        clipper.AddPaths(contours, ClipperLib::ptSubject, true);
+        ClipperUtils::PooledClipper clipper;
+        clipper->AddPaths(contours, ClipperLib::ptSubject, true);
         // Holes may contain holes in holes produced by expanding a C hole shape.
         // The situation is processed correctly by Clipper diff operation, producing concentric expolygons.
-        clipper.AddPaths(holes, ClipperLib::ptClip, true);
+        clipper->AddPaths(holes, ClipperLib::ptClip, true);
         ClipperLib::PolyTree polytree;
-        clipper.Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        clipper->Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
         output = PolyTreeToExPolygons(std::move(polytree));
     }
 
@@ -1382,11 +1429,11 @@ Polygons variable_offset_outer(const ExPolygon &expoly, const std::vector<std::v
         output = std::move(contours);
     else {
         //FIXME the difference is not needed as the holes may never intersect with other holes.
-        ClipperLib::Clipper clipper;
-        clipper.Clear();
-        clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-        clipper.AddPaths(holes, ClipperLib::ptClip, true);
-        clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        ClipperUtils::PooledClipper clipper;
+        clipper->Clear();
+        clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+        clipper->AddPaths(holes, ClipperLib::ptClip, true);
+        clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     }
 
     return to_polygons(std::move(output));
@@ -1424,12 +1471,12 @@ ExPolygons variable_offset_outer_ex(const ExPolygon &expoly, const std::vector<s
         }
 	} else {
         //FIXME the difference is not needed as the holes may never intersect with other holes.
-		ClipperLib::Clipper clipper;
+		ClipperUtils::PooledClipper clipper;
         // Contours may have holes if they were created by closing a C shape.
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
 	    ClipperLib::PolyTree polytree;
-		clipper.Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		clipper->Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	    output = PolyTreeToExPolygons(std::move(polytree));
 	}
 
@@ -336,6 +336,28 @@ namespace ClipperUtils {
     [[nodiscard]] Polygons  clip_clipper_polygons_with_subject_bbox(const Polygons &src, const BoundingBox &bbox);
     [[nodiscard]] Polygons  clip_clipper_polygons_with_subject_bbox(const ExPolygon &src, const BoundingBox &bbox);
     [[nodiscard]] Polygons  clip_clipper_polygons_with_subject_bbox(const ExPolygons &src, const BoundingBox &bbox);
+
+    // ClipperLib::Clipper or ClipperLib::ClipperOffset borrowed from a pool of the calling thread for the lifetime of this object.
+    // The engine is cleared and returned to the pool instead of being destructed, thus the edge arrays, output points
+    // and other work buffers allocated by the engine are reused by the following Clipper operations of the same thread.
+    // Engines are borrowed in a LIFO manner, thus nested Clipper operations get different engines.
+    // A borrowed engine is in its default state.
+    template<typename Engine>
+    class PooledEngine {
+    public:
+        PooledEngine();
+        ~PooledEngine();
+        PooledEngine(const PooledEngine &) = delete;
+        PooledEngine& operator=(const PooledEngine &) = delete;
+
+        Engine& operator*()  const { return *m_engine; }
+        Engine* operator->() const { return m_engine.get(); }
+
+    private:
+        std::unique_ptr<Engine> m_engine;
+    };
+    using PooledClipper       = PooledEngine<ClipperLib::Clipper>;
+    using PooledClipperOffset = PooledEngine<ClipperLib::ClipperOffset>;
 }
 
 // offset Polygons
@@ -142,6 +142,23 @@ ExtrusionEntityCollection ExtrusionEntityCollection::flatten(bool preserve_order
     return flatten.out;
 }
 
+static void collect_leaves(const ExtrusionEntityCollection &collection, std::vector<const ExtrusionEntity*> &out)
+{
+    for (const ExtrusionEntity *entity : collection.entities)
+        if (entity->is_collection())
+            collect_leaves(*static_cast<const ExtrusionEntityCollection*>(entity), out);
+        else
+            out.emplace_back(entity);
+}
+
+// Returns pointers to all non-collection items contained in this one, without cloning them.
+std::vector<const ExtrusionEntity*> ExtrusionEntityCollection::leaves() const
+{
+    std::vector<const ExtrusionEntity*> out;
+    collect_leaves(*this, out);
+    return out;
+}
+
 double ExtrusionEntityCollection::min_mm3_per_mm() const
 {
     double min_mm3_per_mm = std::numeric_limits<double>::max();
@@ -127,6 +127,9 @@ public:
     /// You should be iterating over flatten().entities if you are interested in the underlying ExtrusionEntities (and don't care about hierarchy).
     /// \param preserve_ordering Flag to method that will flatten if and only if the underlying collection is sortable when True (default: False).
     ExtrusionEntityCollection flatten(bool preserve_ordering = false) const;
+    /// Returns the items of this ExtrusionEntityCollection and of its sub-collections that are not collections.
+    /// Unlike flatten(), the items are not cloned, the pointers returned are owned by this collection.
+    std::vector<const ExtrusionEntity*> leaves() const;
     double min_mm3_per_mm() const override;
     double total_volume() const override { double volume=0.; for (const auto& ent : entities) volume+=ent->total_volume(); return volume; }
 
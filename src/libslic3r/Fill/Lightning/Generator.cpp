@@ -2,11 +2,15 @@
 //CuraEngine is released under the terms of the AGPLv3 or higher.
 
 #include "Generator.hpp"
+#include "DistanceField.hpp"
 #include "TreeNode.hpp"
 
 #include "../../ClipperUtils.hpp"
 #include "../../Layer.hpp"
 #include "../../Print.hpp"
+#include "../../TBBPipeline.hpp"
+
+#include <tbb/parallel_for.h>
 
 /* Possible future tasks/optimizations,etc.:
  * - Improve connecting heuristic to favor connecting to shorter trees
@@ -48,33 +52,43 @@ Generator::Generator(const PrintObject &print_object, const coordf_t fill_densit
     m_prune_length                                    = coord_t(layer_thickness * std::tan(lightning_infill_prune_angle));
     m_straightening_max_distance                      = coord_t(layer_thickness * std::tan(lightning_infill_straightening_angle));
 
-    generateInitialInternalOverhangs(print_object, throw_on_cancel_callback);
-    generateTrees(print_object, throw_on_cancel_callback);
+    // Infill areas of all layers, shared by the calculation of the overhangs and of the trees.
+    std::vector<Polygons> infill_outlines(print_object.layers().size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, infill_outlines.size()),
+        [&print_object, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            throw_on_cancel_callback();
+            Polygons infill_area;
+            for (const LayerRegion *layerm : print_object.get_layer(int(layer_id))->regions())
+                for (const Surface &surface : layerm->fill_surfaces())
+                    if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
+                        append(infill_area, to_polygons(surface.expolygon));
+            infill_outlines[layer_id] = union_(infill_area);
+        }
+    });
+
+    generateInitialInternalOverhangs(infill_outlines, throw_on_cancel_callback);
+    generateTrees(infill_outlines, throw_on_cancel_callback);
 }
 
-void Generator::generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_overhang_per_layer.resize(print_object.layers().size());
-
-    Polygons infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = int(print_object.layers().size()) - 1; layer_nr >= 0; --layer_nr) {
-        throw_on_cancel_callback();
-        Polygons infill_area_here;
-        for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
-            for (const Surface& surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_area_here, to_polygons(surface.expolygon));
-
-        infill_area_here = union_(infill_area_here);
-        // Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
-        // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
-        overhang = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
-
-        m_overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+    m_overhang_per_layer.assign(infill_outlines.size(), Polygons());
+
+    // Subtract the infill area above from the infill area of each layer, to get only overhang in the top layer where it is overhanging.
+    // The layers are independent once the infill areas of all layers are known.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, infill_outlines.size()),
+        [this, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_nr = range.begin(); layer_nr < range.end(); ++ layer_nr) {
+            throw_on_cancel_callback();
+            // Remove the part of the infill area that is already supported by the walls.
+            Polygons overhang = offset(infill_outlines[layer_nr], -float(m_wall_supporting_radius));
+            if (layer_nr + 1 < infill_outlines.size())
+                overhang = diff(overhang, infill_outlines[layer_nr + 1]);
+            // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
+            m_overhang_per_layer[layer_nr] = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
+        }
+    });
 }
 
 const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
@@ -83,60 +97,83 @@ const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
     return m_lightning_layers[layer_id];
 }
 
-void Generator::generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateTrees(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_lightning_layers.resize(print_object.layers().size());
-
-    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
-
-    // For-each layer from top to bottom:
-    for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
-            for (const Surface &surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_outlines[layer_id], to_polygons(surface.expolygon));
-
-        infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
-    }
+    m_lightning_layers.resize(infill_outlines.size());
+    if (infill_outlines.empty())
+        return;
 
     // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = print_object.layers().size() - 1;
+    const size_t top_layer_id = infill_outlines.size() - 1;
     EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
     outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
 
+    // Distance field of a layer together with the bounding box of the layer's infill area.
+    struct LayerDistanceField {
+        int                            layer_id { -1 };
+        BoundingBox                    outlines_bbox;
+        std::shared_ptr<DistanceField> distance_field;
+    };
+
+    // The distance fields depend just on the overhangs and outlines of their layer, thus they are calculated in parallel
+    // a few layers ahead of the serial growth of the trees. Only updating them by the trees grown is serial.
+    int next_layer_id = int(top_layer_id);
+    const auto layer_enumerator = tbb::make_filter<void, int>(slic3r_tbb_filtermode::serial_in_order,
+        [&next_layer_id](tbb::flow_control &fc) -> int {
+            if (next_layer_id < 0) {
+                fc.stop();
+                return -1;
+            }
+            return next_layer_id --;
+        });
+    const auto distance_field_builder = tbb::make_filter<int, LayerDistanceField>(slic3r_tbb_filtermode::parallel,
+        [this, &infill_outlines, &throw_on_cancel_callback](int layer_id) -> LayerDistanceField {
+            throw_on_cancel_callback();
+            LayerDistanceField out;
+            out.layer_id       = layer_id;
+            out.outlines_bbox  = get_extents(infill_outlines[layer_id]);
+            out.distance_field = std::make_shared<DistanceField>(m_supporting_radius, infill_outlines[layer_id], out.outlines_bbox, m_overhang_per_layer[layer_id]);
+            return out;
+        });
     // For-each layer from top to bottom:
-    for (int layer_id = int(top_layer_id); layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        Layer             &current_lightning_layer = m_lightning_layers[layer_id];
-        const Polygons    &current_outlines        = infill_outlines[layer_id];
-        const BoundingBox &current_outlines_bbox   = get_extents(current_outlines);
-
-        // register all trees propagated from the previous layer as to-be-reconnected
-        std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
-
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
-        current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
-
-        // Initialize trees for next lower layer from the current one.
-        if (layer_id == 0)
-            return;
-
-        const Polygons &below_outlines      = infill_outlines[layer_id - 1];
-        BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
-        if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
-            below_outlines_bbox.merge(outlines_locator_bbox);
-
-        if (!current_lightning_layer.tree_roots.empty())
-            below_outlines_bbox.merge(get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
-
-        outlines_locator.set_bbox(below_outlines_bbox);
-        outlines_locator.create(below_outlines, locator_cell_size);
-
-        std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
-        for (auto& tree : current_lightning_layer.tree_roots)
-            tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
-    }
+    const auto tree_generator = tbb::make_filter<LayerDistanceField, void>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &infill_outlines, &outlines_locator, &throw_on_cancel_callback](LayerDistanceField in) {
+            throw_on_cancel_callback();
+            const int          layer_id                = in.layer_id;
+            Layer             &current_lightning_layer = m_lightning_layers[layer_id];
+            const Polygons    &current_outlines        = infill_outlines[layer_id];
+            const BoundingBox &current_outlines_bbox   = in.outlines_bbox;
+
+            // register all trees propagated from the previous layer as to-be-reconnected
+            std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
+
+            current_lightning_layer.generateNewTrees(*in.distance_field, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+            current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+            // Release the distance field of this layer, it is not needed anymore.
+            in.distance_field.reset();
+
+            // Initialize trees for next lower layer from the current one.
+            if (layer_id == 0)
+                return;
+
+            const Polygons &below_outlines      = infill_outlines[layer_id - 1];
+            BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
+            if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
+                below_outlines_bbox.merge(outlines_locator_bbox);
+
+            if (!current_lightning_layer.tree_roots.empty())
+                below_outlines_bbox.merge(get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
+
+            outlines_locator.set_bbox(below_outlines_bbox);
+            outlines_locator.create(below_outlines, locator_cell_size);
+
+            std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
+            for (auto& tree : current_lightning_layer.tree_roots)
+                tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        });
+
+    // The number of tokens limits the number of distance fields held in memory at the same time.
+    tbb::parallel_pipeline(16, layer_enumerator & distance_field_builder & tree_generator);
 }
 
 } // namespace Slic3r::FillLightning
@@ -16,6 +16,7 @@
 namespace Slic3r::FillLightning
 {
 
+class DistanceField;
 class Node;
 using NodeSPtr = std::shared_ptr<Node>;
 using SparseNodeGrid = std::unordered_multimap<Point, std::weak_ptr<Node>, PointHash>;
@@ -37,9 +38,14 @@ class Layer
 public:
     std::vector<NodeSPtr> tree_roots;
 
+    /*!
+     * Grow new trees until the distance field of the overhangs is fully supported.
+     * \param distance_field Unsupported points of the overhangs on this layer, precalculated
+     * from the overhang and the outlines of this layer. It is updated as the trees are grown.
+     */
     void generateNewTrees
     (
-        const Polygons& current_overhang,
+        DistanceField& distance_field,
         const Polygons& current_outlines,
         const BoundingBox& current_outlines_bbox,
         const EdgeGrid::Grid& outline_locator,
@@ -13,11 +13,14 @@
 #include "../GCode/ThumbnailData.hpp"
 #include "../Semver.hpp"
 #include "../Time.hpp"
+#include "../TBBPipeline.hpp"
+#include "../Thread.hpp"
 
 #include "../I18N.hpp"
 
 #include "3mf.hpp"
 
+#include <atomic>
 #include <limits>
 #include <stdexcept>
 #include <optional>
@@ -48,6 +51,9 @@ namespace pt = boost::property_tree;
 
 #include <fast_float/fast_float.h>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 // Slightly faster than sprintf("%.9g"), but there is an issue with the karma floating point formatter,
 // https://github.com/boostorg/spirit/pull/586
 // where the exported string is one digit shorter than it should be to guarantee lossless round trip.
@@ -503,6 +509,9 @@ namespace Slic3r {
         Model* m_model;
         float m_unit_factor;
         CurrentObject m_curr_object;
+        // Content of the <mesh> elements parsed ahead of expat, indexed by the offset of the <mesh> start tag in the XML stream
+        // fed to expat. The vertices are not scaled by m_unit_factor yet.
+        std::map<XML_Index, Geometry*> m_parsed_meshes;
         IdToModelObjectMap m_objects;
         IdToAliasesMap m_objects_aliases;
         InstancesList m_instances;
@@ -545,6 +554,9 @@ namespace Slic3r {
         bool _load_model_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions);
         bool _extract_relationships_from_archive(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
         bool _extract_model_from_archive(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
+        bool _extract_model_streamed(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
+        bool _extract_model_buffered(mz_zip_archive &archive, const mz_zip_archive_file_stat &stat);
+        static bool _parse_mesh_content(const char *begin, const char *end, Geometry &geometry);
         bool _is_svg_shape_file(const std::string &filename) const;
         void _extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions);
         void _extract_layer_heights_profile_config_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat);
@@ -1076,6 +1088,13 @@ namespace Slic3r {
         XML_SetElementHandler(m_xml_parser, _3MF_Importer::_handle_start_model_xml_element, _3MF_Importer::_handle_end_model_xml_element);
         XML_SetCharacterDataHandler(m_xml_parser, _3MF_Importer::_handle_model_xml_characters);
 
+        // Parsing the meshes ahead of expat needs the whole model file in memory. Stream huge model files to expat instead.
+        static constexpr const mz_uint64 max_buffered_model_size = 256 * 1024 * 1024;
+        return stat.m_uncomp_size > max_buffered_model_size ? _extract_model_streamed(archive, stat) : _extract_model_buffered(archive, stat);
+    }
+
+    bool _3MF_Importer::_extract_model_streamed(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat)
+    {
         struct CallbackData
         {
             XML_Parser& parser;
@@ -1121,6 +1140,226 @@ namespace Slic3r {
         return true;
     }
 
+    bool _3MF_Importer::_extract_model_buffered(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat)
+    {
+        std::string buffer((size_t)stat.m_uncomp_size, 0);
+        if (mz_zip_reader_extract_to_mem(&archive, stat.m_file_index, (void*)buffer.data(), (size_t)stat.m_uncomp_size, 0) == 0) {
+            add_error("Error while extracting model data from ZIP archive");
+            return false;
+        }
+
+        // The content of the <mesh> elements makes the bulk of a model file. Parse the meshes in parallel ahead of expat,
+        // then let expat parse the rest of the file with the content of the parsed meshes cut out.
+        struct MeshContent {
+            size_t   start_tag;
+            size_t   begin;
+            size_t   end;
+            Geometry geometry;
+            bool     valid { false };
+        };
+        std::vector<MeshContent> meshes;
+        {
+            const std::string_view xml(buffer);
+            const std::string      mesh_start = std::string("<") + MESH_TAG;
+            const std::string      mesh_end   = std::string("</") + MESH_TAG;
+            for (size_t pos = xml.find(mesh_start); pos != std::string_view::npos; pos = xml.find(mesh_start, pos + 1)) {
+                const size_t name_end = pos + mesh_start.size();
+                if (name_end == xml.size() || ! (xml[name_end] == '>' || xml[name_end] == ' ' || xml[name_end] == '\t' || xml[name_end] == '\r' || xml[name_end] == '\n'))
+                    continue;
+                const size_t begin = xml.find('>', name_end);
+                if (begin == std::string_view::npos)
+                    break;
+                if (xml[begin - 1] == '/')
+                    // Empty element.
+                    continue;
+                const size_t end = xml.find(mesh_end, begin);
+                if (end == std::string_view::npos)
+                    break;
+                meshes.push_back({ pos, begin + 1, end });
+                pos = end;
+            }
+        }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size(), 1), [&buffer, &meshes](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                MeshContent &mesh = meshes[i];
+                mesh.valid = _parse_mesh_content(buffer.data() + mesh.begin, buffer.data() + mesh.end, mesh.geometry);
+                if (! mesh.valid)
+                    // Leave the mesh to expat.
+                    mesh.geometry.reset();
+            }
+        });
+
+        // Ranges of the buffer to be parsed by expat, number of lines cut out before each range.
+        struct Segment {
+            size_t begin;
+            size_t end;
+            int    lines_skipped;
+        };
+        std::vector<Segment> segments;
+        {
+            size_t    pos           = 0;
+            XML_Index bytes_skipped = 0;
+            int       lines_skipped = 0;
+            m_parsed_meshes.clear();
+            for (MeshContent &mesh : meshes)
+                if (mesh.valid) {
+                    segments.push_back({ pos, mesh.begin, lines_skipped });
+                    m_parsed_meshes.emplace(XML_Index(mesh.start_tag) - bytes_skipped, &mesh.geometry);
+                    bytes_skipped += XML_Index(mesh.end - mesh.begin);
+                    lines_skipped += int(std::count(buffer.begin() + mesh.begin, buffer.begin() + mesh.end, '\n'));
+                    pos            = mesh.end;
+                }
+            segments.push_back({ pos, buffer.size(), lines_skipped });
+        }
+
+        bool res = true;
+        try
+        {
+            for (size_t i = 0; i < segments.size(); ++ i) {
+                const Segment &segment = segments[i];
+                // Expat takes the length as int, feed it in blocks.
+                static constexpr const size_t max_block = 64 * 1024 * 1024;
+                for (size_t begin = segment.begin; begin < segment.end || (begin == segment.end && i + 1 == segments.size()); begin += max_block) {
+                    const size_t n        = std::min(max_block, segment.end - begin);
+                    const bool   is_final = i + 1 == segments.size() && begin + n == segment.end;
+                    if (!XML_Parse(m_xml_parser, buffer.data() + begin, (int)n, is_final ? 1 : 0) || parse_error()) {
+                        char error_buf[1024];
+                        ::sprintf(error_buf, "Error (%s) while parsing '%s' at line %d", parse_error_message(), stat.m_filename, (int)XML_GetCurrentLineNumber(m_xml_parser) + segment.lines_skipped);
+                        throw Slic3r::FileIOError(error_buf);
+                    }
+                    if (is_final)
+                        break;
+                }
+            }
+        }
+        catch (const version_error& e)
+        {
+            m_parsed_meshes.clear();
+            // rethrow the exception
+            throw Slic3r::FileIOError(e.what());
+        }
+        catch (std::exception& e)
+        {
+            add_error(e.what());
+            res = false;
+        }
+
+        m_parsed_meshes.clear();
+        return res;
+    }
+
+    bool _3MF_Importer::_parse_mesh_content(const char *c, const char *end, Geometry &geometry)
+    {
+        // Accepts just the <vertices>, <vertex>, <triangles> and <triangle> elements with attribute values
+        // not needing any normalization. Anything else is left to expat.
+        auto skip_space   = [end](const char *c) { while (c != end && (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n')) ++ c; return c; };
+        auto is_name_char = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == ':' || c == '_' || c == '-' || c == '.'; };
+        auto skip_name    = [end, &is_name_char](const char *c) { while (c != end && is_name_char(*c)) ++ c; return c; };
+
+        std::vector<std::pair<std::string_view, std::string_view>> attributes;
+        auto attribute = [&attributes](const char *key) {
+            for (const auto &kv : attributes)
+                if (kv.first == key)
+                    return kv.second;
+            return std::string_view();
+        };
+        auto attribute_float = [&attribute](const char *key) {
+            // Same as get_attribute_value_float().
+            float value = 0.0f;
+            std::string_view text = attribute(key);
+            fast_float::from_chars(text.data(), text.data() + text.size(), value);
+            return value;
+        };
+        auto attribute_int = [&attribute](const char *key) {
+            // Same as get_attribute_value_int().
+            int value = 0;
+            std::string_view text = attribute(key);
+            const char *it = text.data();
+            boost::spirit::qi::parse(it, text.data() + text.size(), boost::spirit::qi::int_, value);
+            return value;
+        };
+
+        std::vector<std::string_view> open_elements;
+        for (;;) {
+            c = skip_space(c);
+            if (c == end)
+                return open_elements.empty();
+            if (*c ++ != '<' || c == end)
+                return false;
+            const bool closing = *c == '/';
+            if (closing)
+                ++ c;
+            const char *name_begin = c;
+            c = skip_name(c);
+            const std::string_view name(name_begin, c - name_begin);
+            if (name != VERTICES_TAG && name != VERTEX_TAG && name != TRIANGLES_TAG && name != TRIANGLE_TAG)
+                return false;
+            if (closing) {
+                c = skip_space(c);
+                if (c == end || *c ++ != '>' || open_elements.empty() || open_elements.back() != name)
+                    return false;
+                open_elements.pop_back();
+                continue;
+            }
+
+            attributes.clear();
+            for (;;) {
+                const char *space_begin = c;
+                c = skip_space(c);
+                if (c == end)
+                    return false;
+                if (*c == '/' || *c == '>')
+                    break;
+                // Attributes not separated by white space, not starting with a letter or repeated are not well-formed, leave the error to expat.
+                if (c == space_begin || ! ((*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || *c == '_' || *c == ':'))
+                    return false;
+                const char *key_begin = c;
+                c = skip_name(c);
+                const std::string_view key(key_begin, c - key_begin);
+                for (const auto &kv : attributes)
+                    if (kv.first == key)
+                        return false;
+                c = skip_space(c);
+                if (c == end || *c ++ != '=')
+                    return false;
+                c = skip_space(c);
+                if (c == end || (*c != '"' && *c != '\''))
+                    return false;
+                const char  quote       = *c ++;
+                const char *value_begin = c;
+                for (; c != end && *c != quote; ++ c)
+                    if (*c == '&' || *c == '<' || *c == '\t' || *c == '\r' || *c == '\n')
+                        return false;
+                if (c == end)
+                    return false;
+                attributes.emplace_back(key, std::string_view(value_begin, c ++ - value_begin));
+            }
+            const bool empty_element = *c == '/';
+            if (empty_element && (++ c == end || *c != '>'))
+                return false;
+            ++ c;
+            if (! empty_element)
+                open_elements.emplace_back(name);
+
+            // Same as the _handle_start_vertices(), _handle_start_vertex(), _handle_start_triangles() and _handle_start_triangle().
+            if (name == VERTICES_TAG)
+                geometry.vertices.clear();
+            else if (name == VERTEX_TAG)
+                geometry.vertices.emplace_back(attribute_float(X_ATTR), attribute_float(Y_ATTR), attribute_float(Z_ATTR));
+            else if (name == TRIANGLES_TAG)
+                geometry.triangles.clear();
+            else {
+                geometry.triangles.emplace_back(attribute_int(V1_ATTR), attribute_int(V2_ATTR), attribute_int(V3_ATTR));
+                geometry.custom_supports.emplace_back(attribute(CUSTOM_SUPPORTS_ATTR));
+                geometry.custom_seam.emplace_back(attribute(CUSTOM_SEAM_ATTR));
+                std::string_view mm_segmentation_serialized = attribute(MM_SEGMENTATION_ATTR);
+                if (mm_segmentation_serialized.empty())
+                    mm_segmentation_serialized = attribute("paint_color");
+                geometry.mm_segmentation.emplace_back(mm_segmentation_serialized);
+            }
+        }
+    }
+
     void _3MF_Importer::_extract_cut_information_from_archive(mz_zip_archive& archive, const mz_zip_archive_file_stat& stat, ConfigSubstitutionContext& config_substitutions)
     {
         if (stat.m_uncomp_size > 0) {
@@ -1901,6 +2140,12 @@ namespace Slic3r {
     {
         // reset current geometry
         m_curr_object.geometry.reset();
+        if (auto it = m_parsed_meshes.find(XML_GetCurrentByteIndex(m_xml_parser)); it != m_parsed_meshes.end()) {
+            // The content of this mesh was cut out of the XML stream and parsed in parallel.
+            m_curr_object.geometry = std::move(*it->second);
+            for (Vec3f &v : m_curr_object.geometry.vertices)
+                v *= m_unit_factor;
+        }
         return true;
     }
 
@@ -3068,13 +3313,25 @@ namespace Slic3r {
 #endif
         };
 
-        char buf[256];
+        // The vertices and triangles are formatted in parallel in blocks of a fixed number of entries,
+        // the formatted blocks are compressed in order while the following blocks are being formatted.
+        struct Block
+        {
+            const ModelVolume *volume;
+            const Offsets     *offsets;
+            bool               triangles;
+            int                begin;
+            int                end;
+        };
+        static constexpr const int block_size = 16384;
+        std::vector<Block> blocks;
+
         unsigned int vertices_count = 0;
         for (ModelVolume* volume : object.volumes) {
             if (volume == nullptr)
                 continue;
 
-            volumes_offsets.insert({ volume, Offsets(vertices_count) });
+            auto volume_it = volumes_offsets.insert({ volume, Offsets(vertices_count) }).first;
 
             const indexed_triangle_set &its = volume->mesh().its;
             if (its.vertices.empty()) {
@@ -3084,36 +3341,16 @@ namespace Slic3r {
 
             vertices_count += (int)its.vertices.size();
 
-            const Transform3d& matrix = volume->get_matrix();
-            for (const auto& vertex: its.vertices) {
-                Vec3f v = (matrix * vertex.cast<double>()).cast<float>();
-                char *ptr = buf;
-                boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << VERTEX_TAG << " x=\"");
-                ptr = format_coordinate(v.x(), ptr);
-                boost::spirit::karma::generate(ptr, "\" y=\"");
-                ptr = format_coordinate(v.y(), ptr);
-                boost::spirit::karma::generate(ptr, "\" z=\"");
-                ptr = format_coordinate(v.z(), ptr);
-                boost::spirit::karma::generate(ptr, "\"/>\n");
-                *ptr = '\0';
-                output_buffer += buf;
-                if (! flush())
-                    return false;
-            }
+            for (int i = 0; i < int(its.vertices.size()); i += block_size)
+                blocks.push_back({ volume, &volume_it->second, false, i, std::min(i + block_size, int(its.vertices.size())) });
         }
 
-        output_buffer += "    </";
-        output_buffer += VERTICES_TAG;
-        output_buffer += ">\n    <";
-        output_buffer += TRIANGLES_TAG;
-        output_buffer += ">\n";
-
+        const size_t first_triangle_block = blocks.size();
         unsigned int triangles_count = 0;
         for (ModelVolume* volume : object.volumes) {
             if (volume == nullptr)
                 continue;
 
-            bool is_left_handed = volume->is_left_handed();
             VolumeToOffsetsMap::iterator volume_it = volumes_offsets.find(volume);
             assert(volume_it != volumes_offsets.end());
 
@@ -3124,7 +3361,35 @@ namespace Slic3r {
             triangles_count += (int)its.indices.size();
             volume_it->second.last_triangle_id = triangles_count - 1;
 
-            for (int i = 0; i < int(its.indices.size()); ++ i) {
+            for (int i = 0; i < int(its.indices.size()); i += block_size)
+                blocks.push_back({ volume, &volume_it->second, true, i, std::min(i + block_size, int(its.indices.size())) });
+        }
+
+        auto format_vertices = [&format_coordinate](const Block &block, std::string &out) {
+            const indexed_triangle_set &its    = block.volume->mesh().its;
+            const Transform3d          &matrix = block.volume->get_matrix();
+            char buf[256];
+            for (int i = block.begin; i < block.end; ++ i) {
+                Vec3f v = (matrix * its.vertices[i].cast<double>()).cast<float>();
+                char *ptr = buf;
+                boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << VERTEX_TAG << " x=\"");
+                ptr = format_coordinate(v.x(), ptr);
+                boost::spirit::karma::generate(ptr, "\" y=\"");
+                ptr = format_coordinate(v.y(), ptr);
+                boost::spirit::karma::generate(ptr, "\" z=\"");
+                ptr = format_coordinate(v.z(), ptr);
+                boost::spirit::karma::generate(ptr, "\"/>\n");
+                out.append(buf, ptr);
+            }
+        };
+
+        auto format_triangles = [](const Block &block, std::string &out) {
+            const ModelVolume          *volume          = block.volume;
+            const indexed_triangle_set &its             = volume->mesh().its;
+            const bool                  is_left_handed  = volume->is_left_handed();
+            const unsigned int          first_vertex_id = block.offsets->first_vertex_id;
+            char buf[256];
+            for (int i = block.begin; i < block.end; ++ i) {
                 {
                     const Vec3i &idx = its.indices[i];
                     char *ptr = buf;
@@ -3132,47 +3397,92 @@ namespace Slic3r {
                         " v1=\"" << boost::spirit::int_ <<
                         "\" v2=\"" << boost::spirit::int_ <<
                         "\" v3=\"" << boost::spirit::int_ << "\"",
-                        idx[is_left_handed ? 2 : 0] + volume_it->second.first_vertex_id,
-                        idx[1] + volume_it->second.first_vertex_id,
-                        idx[is_left_handed ? 0 : 2] + volume_it->second.first_vertex_id);
-                    *ptr = '\0';
-                    output_buffer += buf;
+                        idx[is_left_handed ? 2 : 0] + first_vertex_id,
+                        idx[1] + first_vertex_id,
+                        idx[is_left_handed ? 0 : 2] + first_vertex_id);
+                    out.append(buf, ptr);
                 }
 
                 std::string custom_supports_data_string = volume->supported_facets.get_triangle_as_string(i);
                 if (! custom_supports_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SUPPORTS_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_supports_data_string;
-                    output_buffer += "\"";
+                    out += " ";
+                    out += CUSTOM_SUPPORTS_ATTR;
+                    out += "=\"";
+                    out += custom_supports_data_string;
+                    out += "\"";
                 }
 
                 std::string custom_seam_data_string = volume->seam_facets.get_triangle_as_string(i);
                 if (! custom_seam_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SEAM_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_seam_data_string;
-                    output_buffer += "\"";
+                    out += " ";
+                    out += CUSTOM_SEAM_ATTR;
+                    out += "=\"";
+                    out += custom_seam_data_string;
+                    out += "\"";
                 }
 
                 std::string mm_painting_data_string = volume->mm_segmentation_facets.get_triangle_as_string(i);
                 if (! mm_painting_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += MM_SEGMENTATION_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += mm_painting_data_string;
-                    output_buffer += "\"";
+                    out += " ";
+                    out += MM_SEGMENTATION_ATTR;
+                    out += "=\"";
+                    out += mm_painting_data_string;
+                    out += "\"";
                 }
 
-                output_buffer += "/>\n";
+                out += "/>\n";
+            }
+        };
+
+        auto end_vertices = [&output_buffer]() {
+            output_buffer += "    </";
+            output_buffer += VERTICES_TAG;
+            output_buffer += ">\n    <";
+            output_buffer += TRIANGLES_TAG;
+            output_buffer += ">\n";
+        };
 
+        std::atomic<bool> failed { false };
+        size_t next_block = 0;
+        auto producer = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+            [&blocks, &next_block, &failed](tbb::flow_control &fc) -> size_t {
+                if (next_block == blocks.size() || failed) {
+                    fc.stop();
+                    return 0;
+                }
+                return next_block ++;
+            });
+        auto formatter = tbb::make_filter<size_t, std::pair<size_t, std::string>>(slic3r_tbb_filtermode::parallel,
+            [&blocks, &format_vertices, &format_triangles](size_t idx) -> std::pair<size_t, std::string> {
+                const Block &block = blocks[idx];
+                std::string  out;
+                if (block.triangles)
+                    format_triangles(block, out);
+                else
+                    format_vertices(block, out);
+                return { idx, std::move(out) };
+            });
+        auto writer = tbb::make_filter<std::pair<size_t, std::string>, void>(slic3r_tbb_filtermode::serial_in_order,
+            [&output_buffer, &flush, &end_vertices, &failed, first_triangle_block](std::pair<size_t, std::string> block) {
+                if (failed)
+                    return;
+                if (block.first == first_triangle_block)
+                    end_vertices();
+                output_buffer += block.second;
                 if (! flush())
-                    return false;
-            }
+                    failed = true;
+            });
+        {
+            // It registers a handler that sets locales to "C" before any TBB thread starts participating in tbb::parallel_pipeline.
+            TBBLocalesSetter locales_setter;
+            tbb::parallel_pipeline(2 * size_t(tbb::this_task_arena::max_concurrency()), producer & formatter & writer);
         }
+        if (failed)
+            return false;
 
+        if (first_triangle_block == blocks.size())
+            // No triangles.
+            end_vertices();
         output_buffer += "    </";
         output_buffer += TRIANGLES_TAG;
         output_buffer += ">\n   </";
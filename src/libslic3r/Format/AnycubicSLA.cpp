@@ -35,8 +35,6 @@
 #define PREV_H 168
 #define PREV_DPI 42
 
-#define LAYER_SIZE_ESTIMATE (32 * 1024)
-
 namespace Slic3r {
 
 static void anycubicsla_get_pixel_span(const std::uint8_t* ptr, const std::uint8_t* end,
@@ -400,8 +398,10 @@ std::unique_ptr<sla::RasterBase> AnycubicSLAArchive::create_raster() const
     sla::RasterBase::Trafo tr{orientation, mirror};
 
     double gamma = m_cfg.gamma_correction.getFloat();
+    auto backend = m_cfg.sla_rasterizer.value == slarScanline ? sla::RasterBackend::Scanline :
+                                                                sla::RasterBackend::AGG;
 
-    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
+    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr, backend);
 }
 
 sla::RasterEncoder AnycubicSLAArchive::get_encoder() const
@@ -502,14 +502,13 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
                                const ThumbnailsList &thumbnails,
                                const std::string    &/*projectname*/)
 {
-    std::uint32_t layer_count = m_layers.size();
+    std::uint32_t layer_count = this->layer_count();
 
     anycubicsla_format_intro         intro = {};
     anycubicsla_format_header        header = {};
     anycubicsla_format_preview       preview = {};
     anycubicsla_format_layers_header layers_header = {};
     anycubicsla_format_misc          misc = {};
-    std::vector<uint8_t>      layer_images;
     std::uint32_t             image_offset;
 
     assert(m_version == ANYCUBIC_SLA_FORMAT_VERSION_1);
@@ -540,14 +539,12 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
         anycubicsla_write_layers_header(out, layers_header);
 
         //layers
-        layer_images.reserve(layer_count * LAYER_SIZE_ESTIMATE);
         image_offset = intro.image_data_offset;
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+        for (size_t i = 0; i < layer_count; ++ i) {
             anycubicsla_format_layer l;
             std::memset(&l, 0, sizeof(l));
             l.image_offset = image_offset;
-            l.image_size = rst.size();
+            l.image_size = layer_size(i);
             if (i < header.bottom_layer_count) {
                 l.exposure_time_s = header.bottom_exposure_time_s;
                 l.layer_height_mm = misc.bottom_layer_height_mm;
@@ -561,14 +558,11 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
             }
             image_offset += l.image_size;
             anycubicsla_write_layer(out, l);
-            // add the rle encoded layer image into the buffer
-            const char* img_start = reinterpret_cast<const char*>(rst.data());
-            const char* img_end = img_start + rst.size();
-            std::copy(img_start, img_end, std::back_inserter(layer_images));
-            i++;
         }
-        const char* img_buffer = reinterpret_cast<const char*>(layer_images.data());
-        out.write(img_buffer, layer_images.size());
+        // write the rle encoded layer images, read back from the spool one by one
+        read_layers([&out](const sla::EncodedRaster &rst, size_t /*i*/) {
+            out.write(reinterpret_cast<const char*>(rst.data()), rst.size());
+        });
         out.close();
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
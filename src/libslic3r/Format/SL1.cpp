@@ -273,8 +273,10 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
     sla::RasterBase::Trafo tr{orientation, mirror};
 
     double gamma = m_cfg.gamma_correction.getFloat();
+    auto backend = m_cfg.sla_rasterizer.value == slarScanline ? sla::RasterBackend::Scanline :
+                                                                sla::RasterBackend::AGG;
 
-    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
+    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr, backend);
 }
 
 sla::RasterEncoder SL1Archive::get_encoder() const
@@ -326,14 +328,13 @@ void SL1Archive::export_print(Zipper               &zipper,
         zipper.add_entry("config.json");
         zipper << to_json(print, iniconf);
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
-
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
+        // The layers are read back from the spool one by one.
+        read_layers([&zipper, &project](const sla::EncodedRaster &rst, size_t i) {
+            std::string imgname = project + string_printf("%.5d", int(i)) + "." +
                                   rst.extension();
 
             zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+        });
 
         for (const ThumbnailData& data : thumbnails)
             if (data.is_valid())
@@ -5,9 +5,153 @@
 ///|/
 #include "SLAArchiveWriter.hpp"
 #include "SLAArchiveFormatRegistry.hpp"
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/I18N.hpp"
+#include "libslic3r/TBBPipeline.hpp"
+#include "libslic3r/format.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <tbb/task_arena.h>
 
 namespace Slic3r {
 
+class SLAArchiveWriter::LayerSpool {
+    struct Entry {
+        uint64_t offset = 0;
+        size_t   size   = 0;
+    };
+
+    boost::filesystem::path m_path;
+    boost::nowide::fstream  m_file;
+    std::vector<Entry>      m_entries;
+    std::string             m_ext;
+
+    void open()
+    {
+        m_file.open(m_path.string(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (! m_file)
+            throw Slic3r::RuntimeError(format(_u8L("Failed to create the temporary file %1% for the rasterized layers."), m_path.string()));
+    }
+
+public:
+    LayerSpool()
+        : m_path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(".sla_layers.%%%%-%%%%-%%%%-%%%%"))
+    {
+        open();
+    }
+
+    ~LayerSpool()
+    {
+        m_file.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(m_path, ec);
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_file.close();
+        open();
+    }
+
+    void append(const sla::EncodedRaster &rst)
+    {
+        Entry &entry = m_entries.emplace_back();
+        entry.offset = m_entries.size() > 1 ? m_entries[m_entries.size() - 2].offset + m_entries[m_entries.size() - 2].size : 0;
+        entry.size   = rst.size();
+        m_ext        = rst.extension();
+        m_file.write(static_cast<const char *>(rst.data()), std::streamsize(rst.size()));
+        if (! m_file)
+            throw Slic3r::RuntimeError(format(_u8L("Failed to write the rasterized layers into the temporary file %1%."), m_path.string()));
+    }
+
+    size_t size() const { return m_entries.size(); }
+    size_t layer_size(size_t idx) const { return m_entries[idx].size; }
+
+    sla::EncodedRaster read(size_t idx)
+    {
+        const Entry         &entry = m_entries[idx];
+        std::vector<uint8_t> buf(entry.size);
+        m_file.seekg(std::streamoff(entry.offset));
+        m_file.read(reinterpret_cast<char *>(buf.data()), std::streamsize(buf.size()));
+        if (! m_file)
+            throw Slic3r::RuntimeError(format(_u8L("Failed to read the rasterized layers from the temporary file %1%."), m_path.string()));
+        return sla::EncodedRaster(std::move(buf), m_ext);
+    }
+};
+
+SLAArchiveWriter::SLAArchiveWriter() = default;
+SLAArchiveWriter::~SLAArchiveWriter() = default;
+
+size_t SLAArchiveWriter::layer_count() const
+{
+    return m_layers ? m_layers->size() : 0;
+}
+
+size_t SLAArchiveWriter::layer_size(size_t lyrid) const
+{
+    assert(lyrid < layer_count());
+    return m_layers->layer_size(lyrid);
+}
+
+void SLAArchiveWriter::read_layers(const std::function<void(const sla::EncodedRaster &, size_t)> &fn) const
+{
+    for (size_t i = 0; i < layer_count(); ++ i)
+        fn(m_layers->read(i), i);
+}
+
+void SLAArchiveWriter::draw_layers(
+    size_t                                                   layer_num,
+    const std::function<void(sla::RasterBase &, size_t)>   &drawfn,
+    const std::function<bool()>                             &cancelfn)
+{
+    if (m_layers)
+        m_layers->clear();
+    else
+        m_layers = std::make_unique<LayerSpool>();
+
+    // The layers are rasterized and encoded in parallel, but they are
+    // spooled in order and the number of live tokens limits how many
+    // layers are held in memory at a time.
+    struct EncodedLayer {
+        size_t             idx = 0;
+        sla::EncodedRaster raster;
+    };
+
+    size_t next_idx = 0;
+    auto producer = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [layer_num, &cancelfn, &next_idx](tbb::flow_control &fc) -> size_t {
+            if (next_idx == layer_num || cancelfn()) {
+                fc.stop();
+                return 0;
+            }
+            return next_idx ++;
+        });
+
+    auto encoder = tbb::make_filter<size_t, EncodedLayer>(slic3r_tbb_filtermode::parallel,
+        [this, &drawfn, &cancelfn](size_t idx) -> EncodedLayer {
+            EncodedLayer out;
+            out.idx = idx;
+            if (! cancelfn()) {
+                auto rst = create_raster();
+                drawfn(*rst, idx);
+                out.raster = rst->encode(get_encoder());
+            }
+            return out;
+        });
+
+    auto writer = tbb::make_filter<EncodedLayer, void>(slic3r_tbb_filtermode::serial_in_order,
+        [this](EncodedLayer layer) {
+            assert(layer.idx == m_layers->size());
+            m_layers->append(layer.raster);
+        });
+
+    tbb::parallel_pipeline(LayersInFlightPerThread * size_t(tbb::this_task_arena::max_concurrency()),
+        producer & encoder & writer);
+}
+
 std::unique_ptr<SLAArchiveWriter>
 SLAArchiveWriter::create(const std::string &archtype, const SLAPrinterConfig &cfg)
 {
@@ -5,6 +5,8 @@
 #ifndef SLAARCHIVE_HPP
 #define SLAARCHIVE_HPP
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "libslic3r/SLA/RasterBase.hpp"
@@ -17,36 +19,37 @@ class SLAPrint;
 class SLAPrinterConfig;
 
 class SLAArchiveWriter {
-protected:
-    std::vector<sla::EncodedRaster> m_layers;
+    // The encoded layers are written into a temporary file as soon as they
+    // are encoded and they are read back one by one when exporting.
+    class LayerSpool;
+    std::unique_ptr<LayerSpool> m_layers;
 
+protected:
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
 
+    // Number of the layers drawn by the last call to draw_layers().
+    size_t layer_count() const;
+    // Size in bytes of an encoded layer.
+    size_t layer_size(size_t lyrid) const;
+    // Read the encoded layers back in the order of the layers:
+    // void(const sla::EncodedRaster&, size_t lyrid);
+    void read_layers(const std::function<void(const sla::EncodedRaster &, size_t)> &fn) const;
+
 public:
-    virtual ~SLAArchiveWriter() = default;
+    // Number of layers being rasterized or encoded at a time per thread.
+    // Only these layers are held in memory, the encoded layers are spooled.
+    static constexpr size_t LayersInFlightPerThread = 2;
+
+    SLAArchiveWriter();
+    virtual ~SLAArchiveWriter();
 
+    // Rasterize and encode the layers in parallel.
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
-    template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
-        size_t     layer_num,
-        Fn &&      drawfn,
-        CancelFn cancelfn = []() { return false; },
-        const EP & ep       = {})
-    {
-        m_layers.resize(layer_num);
-        execution::for_each(
-            ep, size_t(0), m_layers.size(),
-            [this, &drawfn, &cancelfn](size_t idx) {
-                if (cancelfn()) return;
-
-                sla::EncodedRaster &enc = m_layers[idx];
-                auto                rst = create_raster();
-                drawfn(*rst, idx);
-                enc = rst->encode(get_encoder());
-            },
-            execution::max_concurrency(ep));
-    }
+        size_t                                                   layer_num,
+        const std::function<void(sla::RasterBase &, size_t)>   &drawfn,
+        const std::function<bool()>                             &cancelfn = []() { return false; });
 
     // Export the print into an archive using the provided filename.
     virtual void export_print(const std::string     fname,
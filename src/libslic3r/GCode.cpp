@@ -66,25 +66,10 @@
 #include <boost/nowide/cstdlib.hpp>
 
 #include "SVG.hpp"
+#include "TBBPipeline.hpp"
 
 #include <tbb/parallel_for.h>
 
-// Intel redesigned some TBB interface considerably when merging TBB with their oneAPI set of libraries, see GH #7332.
-// We are using quite an old TBB 2017 U7. Before we update our build servers, let's use the old API, which is deprecated in up to date TBB.
-#if ! defined(TBB_VERSION_MAJOR)
-    #include <tbb/version.h>
-#endif
-#if ! defined(TBB_VERSION_MAJOR)
-    static_assert(false, "TBB_VERSION_MAJOR not defined");
-#endif
-#if TBB_VERSION_MAJOR >= 2021
-    #include <tbb/parallel_pipeline.h>
-    using slic3r_tbb_filtermode = tbb::filter_mode;
-#else
-    #include <tbb/pipeline.h>
-    using slic3r_tbb_filtermode = tbb::filter;
-#endif
-
 using namespace std::literals::string_view_literals;
 
 #if 0
@@ -1483,6 +1468,34 @@ void GCodeGenerator::smooth_path_interpolate(
         out.interpolate_add(layer->support_fills, params);
 }
 
+GCodeGenerator::PreparedLayer GCodeGenerator::prepare_layer(
+    const Print                                             &print,
+    const LayerTools                                        &layer_tools,
+    const ObjectsLayerToPrint                               &layers,
+    const GCode::SmoothPathCache::InterpolationParameters   &interpolation_params)
+{
+    PreparedLayer out;
+    for (const ObjectLayerToPrint &l : layers)
+        GCodeGenerator::smooth_path_interpolate(l, interpolation_params, out.smooth_path_cache);
+    // Mirrors the initialization of the avoid crossing perimeters in extrude_layer() and of the travel obstacle tracker
+    // in process_layer(). If the layer is not prepared here, it is calculated there.
+    if (print.config().avoid_crossing_perimeters)
+        for (const ObjectLayerToPrint &l : layers)
+            out.lslices_offsets.emplace_back(AvoidCrossingPerimeters::make_layer_slices_offset(*l.layer()));
+    const Layer *layer = nullptr;
+    for (const ObjectLayerToPrint &l : layers)
+        if (l.object_layer) {
+            layer = l.object_layer;
+            break;
+        }
+    if (layer == nullptr && ! layers.empty())
+        layer = layers.front().support_layer;
+    if (layer != nullptr && layer->lower_layer != nullptr && ! layer_tools.extruders.empty() &&
+        line_distancer_is_required(print.config(), layer_tools.extruders))
+        out.travel_obstacles = GCode::TravelObstacleTracker::make_layer_distancers(*layer, layers);
+    return out;
+}
+
 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
 // and export G-code into file.
@@ -1496,29 +1509,31 @@ void GCodeGenerator::process_layers(
 {
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, &interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
-            if (layer_to_print_idx >= layers_to_print.size()) {
-                if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
-                    fc.stop();
-                    return {};
-                } else {
-                    // Pressure equalizer need insert empty input. Because it returns one layer back.
-                    // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
-                }
-            } else {
-                print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
-                for (const ObjectLayerToPrint &l : layers_to_print[idx].second)
-                    GCodeGenerator::smooth_path_interpolate(l, interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
+    const auto layer_enumerator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
+            // Pressure equalizer need insert empty input. Because it returns one layer back.
+            // One NOP (no operation) layer is emitted past the last layer to print.
+            if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
+                fc.stop();
+                return {};
             }
+            return layer_to_print_idx ++;
         });
-    const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+    // Smoothing of extrusion paths (arc fitting, polyline decimation) and the obstacles for travel planning do not depend
+    // on the state of the G-code generator, thus they are prepared for multiple layers in parallel.
+    // Only process_layer() below has to run serially, as each G-code line it emits depends on the machine state.
+    const auto layer_preparator = tbb::make_filter<size_t, std::pair<size_t, PreparedLayer>>(slic3r_tbb_filtermode::parallel,
+        [&print, &tool_ordering, &layers_to_print, &interpolation_params](size_t idx) -> std::pair<size_t, PreparedLayer> {
+            if (idx >= layers_to_print.size())
+                // NOP layer for pressure equalizer.
+                return { idx, {} };
+            print.throw_if_canceled();
+            const std::pair<coordf_t, ObjectsLayerToPrint> &layer = layers_to_print[idx];
+            return { idx, GCodeGenerator::prepare_layer(print, tool_ordering.tools_for_layer(layer.first), layer.second, interpolation_params) };
+        });
+    const auto generator = tbb::make_filter<std::pair<size_t, PreparedLayer>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [this, &print, &tool_ordering, &print_object_instances_ordering, &layers_to_print, &smooth_path_cache_global](
-            std::pair<size_t, GCode::SmoothPathCache> in) -> LayerResult {
+            std::pair<size_t, PreparedLayer> in) -> LayerResult {
             size_t layer_to_print_idx = in.first;
             if (layer_to_print_idx == layers_to_print.size()) {
                 // Pressure equalizer need insert empty input. Because it returns one layer back.
@@ -1530,8 +1545,10 @@ void GCodeGenerator::process_layers(
                 if (m_wipe_tower && layer_tools.has_wipe_tower)
                     m_wipe_tower->next_layer();
                 print.throw_if_canceled();
+                m_avoid_crossing_perimeters.set_prepared_layers(std::move(in.second.lslices_offsets));
+                m_travel_obstacle_tracker.set_prepared_layer(std::move(in.second.travel_obstacles));
                 return this->process_layer(print, layer.second, layer_tools, 
-                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
+                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second.smooth_path_cache }, 
                     &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1));
             }
         });
@@ -1555,7 +1572,8 @@ void GCodeGenerator::process_layers(
 
              return cooling_buffer->process_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
         });
-    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+    // Find / replace is stateless, layers are processed in parallel and reordered by the output filter.
+    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::parallel,
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
             return find_replace->process_layer(std::move(s));
         });
@@ -1563,7 +1581,7 @@ void GCodeGenerator::process_layers(
         [&output_stream](std::string s) { output_stream.write(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_enumerator & layer_preparator & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
@@ -1595,27 +1613,30 @@ void GCodeGenerator::process_layers(
 {
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>> (slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
-            if (layer_to_print_idx >= layers_to_print.size()) {
-                if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
-                    fc.stop();
-                    return {};
-                } else {
-                    // Pressure equalizer need insert empty input. Because it returns one layer back.
-                    // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
-                }
-            } else {
-                print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
-                GCodeGenerator::smooth_path_interpolate(layers_to_print[idx], interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
+    const auto layer_enumerator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
+            // Pressure equalizer need insert empty input. Because it returns one layer back.
+            // One NOP (no operation) layer is emitted past the last layer to print.
+            if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
+                fc.stop();
+                return {};
             }
+            return layer_to_print_idx ++;
+        });
+    // Smoothing of extrusion paths and the obstacles for travel planning do not depend on the state of the G-code generator,
+    // thus they are prepared in parallel.
+    // Note that the generator below moves the ObjectLayerToPrint out of layers_to_print only after its layer was prepared.
+    const auto layer_preparator = tbb::make_filter<size_t, std::pair<size_t, PreparedLayer>>(slic3r_tbb_filtermode::parallel,
+        [&print, &tool_ordering, &layers_to_print, interpolation_params](size_t idx) -> std::pair<size_t, PreparedLayer> {
+            if (idx >= layers_to_print.size())
+                // NOP layer for pressure equalizer.
+                return { idx, {} };
+            print.throw_if_canceled();
+            const ObjectLayerToPrint &layer = layers_to_print[idx];
+            return { idx, GCodeGenerator::prepare_layer(print, tool_ordering.tools_for_layer(layer.print_z()), { layer }, interpolation_params) };
         });
-    const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global, single_object_idx](std::pair<size_t, GCode::SmoothPathCache> in) -> LayerResult {
+    const auto generator = tbb::make_filter<std::pair<size_t, PreparedLayer>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global, single_object_idx](std::pair<size_t, PreparedLayer> in) -> LayerResult {
             size_t layer_to_print_idx = in.first;
             if (layer_to_print_idx == layers_to_print.size()) {
                 // Pressure equalizer need insert empty input. Because it returns one layer back.
@@ -1624,8 +1645,10 @@ void GCodeGenerator::process_layers(
             } else {
                 ObjectLayerToPrint &layer = layers_to_print[layer_to_print_idx];
                 print.throw_if_canceled();
+                m_avoid_crossing_perimeters.set_prepared_layers(std::move(in.second.lslices_offsets));
+                m_travel_obstacle_tracker.set_prepared_layer(std::move(in.second.travel_obstacles));
                 return this->process_layer(print, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), 
-                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
+                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second.smooth_path_cache }, 
                     &layer == &layers_to_print.back(), nullptr, single_object_idx);
             }
         });
@@ -1648,7 +1671,8 @@ void GCodeGenerator::process_layers(
                 return in.gcode;
             return cooling_buffer->process_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
         });
-    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+    // Find / replace is stateless, layers are processed in parallel and reordered by the output filter.
+    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::parallel,
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
             return find_replace->process_layer(std::move(s));
         });
@@ -1656,7 +1680,7 @@ void GCodeGenerator::process_layers(
         [&output_stream](std::string s) { output_stream.write(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_enumerator & layer_preparator & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
@@ -2158,12 +2182,12 @@ namespace Skirt {
 
 } // namespace Skirt
 
-bool GCodeGenerator::line_distancer_is_required(const std::vector<unsigned int>& extruder_ids) {
+bool GCodeGenerator::line_distancer_is_required(const GCodeConfig &config, const std::vector<unsigned int>& extruder_ids) {
     for (const unsigned id : extruder_ids) {
-        const double travel_slope{this->m_config.travel_slope.get_at(id)};
+        const double travel_slope{config.travel_slope.get_at(id)};
         if (
-            this->m_config.travel_lift_before_obstacle.get_at(id)
-            && this->m_config.travel_max_lift.get_at(id) > 0
+            config.travel_lift_before_obstacle.get_at(id)
+            && config.travel_max_lift.get_at(id) > 0
             && travel_slope > 0
             && travel_slope < 90
         ) {
@@ -2391,7 +2415,7 @@ LayerResult GCodeGenerator::process_layer(
     }
     gcode += this->change_layer(previous_layer_z, print_z, result.spiral_vase_enable); // this will increase m_layer_index
     m_layer = &layer;
-    if (this->line_distancer_is_required(layer_tools.extruders) && this->m_layer != nullptr && this->m_layer->lower_layer != nullptr)
+    if (line_distancer_is_required(m_config, layer_tools.extruders) && this->m_layer != nullptr && this->m_layer->lower_layer != nullptr)
         m_travel_obstacle_tracker.init_layer(layer, layers);
 
     m_object_layer_over_raft = false;
@@ -3170,14 +3194,41 @@ void GCodeGenerator::GCodeOutputStream::close()
     }
 }
 
+GCodeGenerator::GCodeOutputStream::GCodeOutputStream(FILE *f, GCodeProcessor &processor) : f(f), m_processor(processor)
+{
+    if (this->f) {
+        m_buffer = std::make_unique<char[]>(buffer_size);
+        ::setvbuf(this->f, m_buffer.get(), _IOFBF, buffer_size);
+    }
+}
+
+void GCodeGenerator::GCodeOutputStream::write_block(const char *begin, const char *end)
+{
+    assert(*end == 0);
+    if (begin != end) {
+        // writes string to file
+        ::fwrite(begin, 1, end - begin, this->f);
+        m_processor.process_buffer(begin, end);
+    }
+}
+
+void GCodeGenerator::GCodeOutputStream::write(const std::string &what)
+{
+    if (m_find_replace) {
+        std::string gcode = m_find_replace->process_layer(what);
+        this->write_block(gcode.c_str(), gcode.c_str() + gcode.size());
+    } else
+        this->write_block(what.c_str(), what.c_str() + what.size());
+}
+
 void GCodeGenerator::GCodeOutputStream::write(const char *what)
 {
     if (what != nullptr) {
-        //FIXME don't allocate a string, maybe process a batch of lines?
-        std::string gcode(m_find_replace ? m_find_replace->process_layer(what) : what);
-        // writes string to file
-        fwrite(gcode.c_str(), 1, gcode.size(), this->f);
-        m_processor.process_buffer(gcode);
+        if (m_find_replace) {
+            std::string gcode = m_find_replace->process_layer(what);
+            this->write_block(gcode.c_str(), gcode.c_str() + gcode.size());
+        } else
+            this->write_block(what, what + strlen(what));
     }
 }
 
@@ -185,7 +185,7 @@ public:
 private:
     class GCodeOutputStream {
     public:
-        GCodeOutputStream(FILE *f, GCodeProcessor &processor) : f(f), m_processor(processor) {}
+        GCodeOutputStream(FILE *f, GCodeProcessor &processor);
         ~GCodeOutputStream() { this->close(); }
 
         // Set a find-replace post-processor to modify the G-code before GCodePostProcessor.
@@ -202,7 +202,8 @@ private:
         void close();
 
         // Write a string into a file.
-        void write(const std::string& what) { this->write(what.c_str()); }
+        // If no find-replace is active, the string is passed to the file and to the G-code processor without being copied.
+        void write(const std::string& what);
         void write(const char* what);
 
         // Write a string into a file. 
@@ -214,7 +215,15 @@ private:
         void write_format(const char* format, ...);
 
     private:
+        // Write a zero terminated block of G-code lines into the file, then let the G-code processor parse it in place.
+        void write_block(const char *begin, const char *end);
+
+        // Size of the stdio output buffer. Whole layers are written at once, thus a large buffer reduces the number of system calls.
+        static constexpr const size_t buffer_size = 1024 * 1024;
+
         FILE             *f { nullptr };
+        // Output buffer installed into f with setvbuf(), it has to outlive the FILE.
+        std::unique_ptr<char[]> m_buffer;
         // Find-replace post-processor to be called before GCodePostProcessor.
         GCodeFindReplace *m_find_replace { nullptr };
         // If suppressed, the backoup holds m_find_replace.
@@ -249,6 +258,18 @@ private:
         // If set to size_t(-1), then print all copies of all objects.
         // Otherwise print a single copy of a single object.
         const size_t                     single_object_idx = size_t(-1));
+    // Data of a single print_z, which does not depend on the state of the G-code generator,
+    // thus it is calculated for multiple layers in parallel by process_layers() before process_layer() is called.
+    struct PreparedLayer {
+        GCode::SmoothPathCache                                                          smooth_path_cache;
+        std::vector<std::shared_ptr<const AvoidCrossingPerimeters::LayerSlicesOffset>>  lslices_offsets;
+        std::optional<GCode::TravelObstacleTracker::LayerDistancers>                    travel_obstacles;
+    };
+    static PreparedLayer prepare_layer(
+        const Print                                             &print,
+        const LayerTools                                        &layer_tools,
+        const ObjectsLayerToPrint                               &layers,
+        const GCode::SmoothPathCache::InterpolationParameters   &interpolation_params);
     // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
     // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
     // and export G-code into file.
@@ -351,7 +372,7 @@ private:
     std::string     retract_and_wipe(bool toolchange = false, bool reset_e = true);
     std::string     unretract() { return m_writer.unretract(); }
     std::string     set_extruder(unsigned int extruder_id, double print_z);
-    bool line_distancer_is_required(const std::vector<unsigned int>& extruder_ids);
+    static bool line_distancer_is_required(const GCodeConfig &config, const std::vector<unsigned int>& extruder_ids);
 
     Seams::Placer                       m_seam_placer;
 
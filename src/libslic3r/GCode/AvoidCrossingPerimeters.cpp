@@ -13,6 +13,7 @@
 #include "../SVG.hpp"
 #include "AvoidCrossingPerimeters.hpp"
 
+#include <algorithm>
 #include <numeric>
 #include <unordered_set>
 #include <boost/range/adaptor/reversed.hpp>
@@ -1187,7 +1188,7 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCodeGenerator &gcodegen, cons
     Vec2d endf   = end  .cast<double>();
 
     bool is_support_layer = dynamic_cast<const SupportLayer *>(gcodegen.layer()) != nullptr;
-    if (!use_external && (is_support_layer || (!m_lslices_offset.empty() && !any_expolygon_contains(m_lslices_offset, m_lslices_offset_bboxes, m_grid_lslices_offset, travel)))) {
+    if (!use_external && (is_support_layer || (!m_lslices_offset->lslices_offset.empty() && !any_expolygon_contains(m_lslices_offset->lslices_offset, m_lslices_offset->lslices_offset_bboxes, m_lslices_offset->grid_lslices_offset, travel)))) {
         // Initialize m_internal only when it is necessary.
         if (m_internal.boundaries.empty())
             init_boundary(&m_internal, to_polygons(get_boundary(*gcodegen.layer())));
@@ -1237,32 +1238,47 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCodeGenerator &gcodegen, cons
     } else if (max_detour_length_exceeded) {
         *could_be_wipe_disabled = false;
     } else
-        *could_be_wipe_disabled = !need_wipe(gcodegen, m_lslices_offset, m_lslices_offset_bboxes, m_grid_lslices_offset, travel, result_pl, travel_intersection_count);
+        *could_be_wipe_disabled = !need_wipe(gcodegen, m_lslices_offset->lslices_offset, m_lslices_offset->lslices_offset_bboxes, m_lslices_offset->grid_lslices_offset, travel, result_pl, travel_intersection_count);
 
     return result_pl;
 }
 
 // ************************************* AvoidCrossingPerimeters::init_layer() *****************************************
 
-void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+std::shared_ptr<const AvoidCrossingPerimeters::LayerSlicesOffset> AvoidCrossingPerimeters::make_layer_slices_offset(const Layer &layer)
 {
-    m_internal.clear();
-    m_external.clear();
-    m_lslices_offset.clear();
-    m_lslices_offset_bboxes.clear();
+    auto out = std::make_shared<LayerSlicesOffset>();
+    out->layer = &layer;
 
     float perimeter_offset = -get_external_perimeter_width(layer) / float(2.);
-    m_lslices_offset        = offset_ex(layer.lslices, perimeter_offset);
+    out->lslices_offset    = offset_ex(layer.lslices, perimeter_offset);
 
-    m_lslices_offset_bboxes.reserve(m_lslices_offset.size());
-    for (const ExPolygon &ex_poly : m_lslices_offset)
-        m_lslices_offset_bboxes.emplace_back(get_extents(ex_poly));
+    out->lslices_offset_bboxes.reserve(out->lslices_offset.size());
+    for (const ExPolygon &ex_poly : out->lslices_offset)
+        out->lslices_offset_bboxes.emplace_back(get_extents(ex_poly));
 
     BoundingBox bbox_slice(get_extents(layer.lslices));
     bbox_slice.offset(SCALED_EPSILON);
 
-    m_grid_lslices_offset.set_bbox(bbox_slice);
-    m_grid_lslices_offset.create(m_lslices_offset, coord_t(scale_(1.)));
+    out->grid_lslices_offset.set_bbox(bbox_slice);
+    out->grid_lslices_offset.create(out->lslices_offset, coord_t(scale_(1.)));
+    return out;
+}
+
+void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+{
+    m_internal.clear();
+    m_external.clear();
+
+    auto find_prepared = [&layer](const std::vector<std::shared_ptr<const LayerSlicesOffset>> &prepared) {
+        auto it = std::find_if(prepared.begin(), prepared.end(), [&layer](const auto &l) { return l->layer == &layer; });
+        return it == prepared.end() ? nullptr : *it;
+    };
+    m_lslices_offset = find_prepared(m_prepared_layers);
+    if (! m_lslices_offset)
+        m_lslices_offset = find_prepared(m_prepared_layers_previous);
+    if (! m_lslices_offset)
+        m_lslices_offset = make_layer_slices_offset(layer);
 }
 
 #if 0
@@ -9,6 +9,9 @@
 #include "../ExPolygon.hpp"
 #include "../EdgeGrid.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace Slic3r {
 
 // Forward declarations.
@@ -26,6 +29,25 @@ public:
     bool        disabled_once() const   { return m_disabled_once; }
     void        reset_once_modifiers()  { use_external_mp_once = false; m_disabled_once = false; }
 
+    // Layer slices offset by half an external perimeter width, used for detection whether a line or polyline
+    // is inside of any polygon. They only depend on the layer, thus they may be calculated in advance,
+    // for multiple layers in parallel.
+    struct LayerSlicesOffset {
+        const Layer             *layer { nullptr };
+        ExPolygons               lslices_offset;
+        std::vector<BoundingBox> lslices_offset_bboxes;
+        EdgeGrid::Grid           grid_lslices_offset;
+    };
+    static std::shared_ptr<const LayerSlicesOffset> make_layer_slices_offset(const Layer &layer);
+
+    // Hand over the layer slices offsets calculated in advance for the layers to be printed next.
+    // The offsets handed over by the previous call are kept for the travel of the layer change.
+    void        set_prepared_layers(std::vector<std::shared_ptr<const LayerSlicesOffset>> &&layers) {
+        m_prepared_layers_previous = std::move(m_prepared_layers);
+        m_prepared_layers          = std::move(layers);
+    }
+
+    // Uses the layer slices offset handed over by set_prepared_layers() if available, calculates it otherwise.
     void        init_layer(const Layer &layer);
 
     Polyline    travel_to(const GCodeGenerator &gcodegen, const Point& point)
@@ -61,11 +83,10 @@ private:
     // we enable it by default for the first travel move in print
     bool           m_disabled_once { true };
 
-    // Lslices offseted by half an external perimeter width. Used for detection if line or polyline is inside of any polygon.
-    ExPolygons               m_lslices_offset;
-    std::vector<BoundingBox> m_lslices_offset_bboxes;
-    // Used for detection of line or polyline is inside of any polygon.
-    EdgeGrid::Grid           m_grid_lslices_offset;
+    // Lslices offseted by half an external perimeter width of the current layer.
+    std::shared_ptr<const LayerSlicesOffset>                m_lslices_offset { std::make_shared<const LayerSlicesOffset>() };
+    std::vector<std::shared_ptr<const LayerSlicesOffset>>   m_prepared_layers;
+    std::vector<std::shared_ptr<const LayerSlicesOffset>>   m_prepared_layers_previous;
     // Store all needed data for travels inside object
     Boundary m_internal;
     // Store all needed data for travels outside object
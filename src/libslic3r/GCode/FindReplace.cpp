@@ -109,7 +109,7 @@ static void find_and_replace_whole_word(std::string &inout, const std::string &m
     }
 }
 
-std::string GCodeFindReplace::process_layer(const std::string &ain)
+std::string GCodeFindReplace::process_layer(const std::string &ain) const
 {
     std::string out;
     const std::string *in = &ain;
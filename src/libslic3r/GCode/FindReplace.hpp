@@ -17,7 +17,7 @@ public:
     GCodeFindReplace(const std::vector<std::string> &gcode_substitutions);
 
 
-    std::string process_layer(const std::string &gcode);
+    std::string process_layer(const std::string &gcode) const;
     
 private:
     struct Substitution {
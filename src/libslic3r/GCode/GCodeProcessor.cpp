@@ -24,6 +24,8 @@
 #include <float.h>
 #include <assert.h>
 
+#include <tbb/parallel_invoke.h>
+
 #if __has_include(<charconv>)
     #include <charconv>
     #include <utility>
@@ -1151,7 +1153,9 @@ void GCodeProcessor::process_ascii_file(const std::string& filename, std::functi
     m_result.id = ++s_result_id;
     initialize_result_moves();
     size_t parse_line_callback_cntr = 10000;
-    m_parser.parse_file(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
+    const auto time_start = std::chrono::high_resolution_clock::now();
+    // The file is tokenized in parallel, only process_gcode_line() is executed serially.
+    m_parser.parse_file_parallel(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
         if (-- parse_line_callback_cntr == 0) {
             // Don't call the cancel_callback() too often, do it every at every 10000'th line.
             parse_line_callback_cntr = 10000;
@@ -1160,6 +1164,12 @@ void GCodeProcessor::process_ascii_file(const std::string& filename, std::functi
         }
         this->process_gcode_line(line, true);
     }, m_result.lines_ends);
+    {
+        const double time_parse = 0.000001 * std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - time_start).count();
+        const double size_mb    = m_result.lines_ends.empty() || m_result.lines_ends.front().empty() ? 0. : double(m_result.lines_ends.front().back()) / (1024. * 1024.);
+        BOOST_LOG_TRIVIAL(debug) << "GCodeProcessor processed " << m_line_id << " lines (" << size_mb << " MB) of " << filename <<
+            " in " << time_parse << " s, " << (time_parse > 0. ? size_mb / time_parse : 0.) << " MB/s";
+    }
 
     // Don't post-process the G-code to update time stamps.
     this->finalize(false);
@@ -1320,10 +1330,10 @@ void GCodeProcessor::initialize(const std::string& filename)
     m_result.id = ++s_result_id;
 }
 
-void GCodeProcessor::process_buffer(const std::string &buffer)
+void GCodeProcessor::process_buffer(const char *begin, const char *end)
 {
     //FIXME maybe cache GCodeLine gline to be over multiple parse_buffer() invocations.
-    m_parser.parse_buffer(buffer, [this](GCodeReader&, const GCodeReader::GCodeLine& line) { 
+    m_parser.parse_buffer(begin, end, [this](GCodeReader&, const GCodeReader::GCodeLine& line) { 
         this->process_gcode_line(line, false);
     });
 }
@@ -1786,7 +1796,8 @@ void GCodeProcessor::process_gcode_line(const GCodeReader::GCodeLine& line, bool
         if (comment.length() > 2 && comment.front() == ';')
             // Process tags embedded into comments. Tag comments always start at the start of a line
             // with a comment and continue with a tag without any whitespace separator.
-            process_tags(comment.substr(1), producers_enabled);
+            // Pass a view into the line to avoid allocating a copy of every comment line.
+            process_tags(std::string_view(comment).substr(1), producers_enabled);
     }
 }
 
@@ -4618,13 +4629,23 @@ void GCodeProcessor::process_filaments(CustomGCode::Type code)
 void GCodeProcessor::calculate_time(GCodeProcessorResult& result, size_t keep_last_n_blocks, float additional_time)
 {
     // calculate times
-    std::vector<TimeMachine::ActualSpeedMove> actual_speed_moves;
-    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-        TimeMachine& machine = m_time_processor.machines[i];
-        machine.calculate_time(m_result, static_cast<PrintEstimatedStatistics::ETimeMode>(i), keep_last_n_blocks, additional_time);
-        if (static_cast<PrintEstimatedStatistics::ETimeMode>(i) == PrintEstimatedStatistics::ETimeMode::Normal)
-            actual_speed_moves = std::move(machine.actual_speed_moves);
+    // The time machines are independent: Each one writes its own slot of MoveVertex::time only, the actual speed
+    // moves are collected by the Normal machine only. Plan the Normal and Stealth modes concurrently if both are enabled.
+    TimeMachine &machine_normal  = m_time_processor.machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)];
+    TimeMachine &machine_stealth = m_time_processor.machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Stealth)];
+    auto calculate_normal  = [this, &machine_normal, keep_last_n_blocks, additional_time]() {
+        machine_normal.calculate_time(m_result, PrintEstimatedStatistics::ETimeMode::Normal, keep_last_n_blocks, additional_time);
+    };
+    auto calculate_stealth = [this, &machine_stealth, keep_last_n_blocks, additional_time]() {
+        machine_stealth.calculate_time(m_result, PrintEstimatedStatistics::ETimeMode::Stealth, keep_last_n_blocks, additional_time);
+    };
+    if (machine_normal.enabled && machine_stealth.enabled && machine_normal.blocks.size() >= TimeProcessor::Planner::queue_size)
+        tbb::parallel_invoke(calculate_normal, calculate_stealth);
+    else {
+        calculate_normal();
+        calculate_stealth();
     }
+    std::vector<TimeMachine::ActualSpeedMove> actual_speed_moves = std::move(machine_normal.actual_speed_moves);
 
     // insert actual speed moves into the move list. We will do this in two stages (to avoid inserting in the middle of
     // result.moves repeatedly). First, we create individual vectors of MoveVertices, and store them along with their
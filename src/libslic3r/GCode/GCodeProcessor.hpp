@@ -596,7 +596,10 @@ namespace Slic3r {
             assert(m_result.moves.empty());
             m_result.moves.emplace_back(GCodeProcessorResult::MoveVertex());
         }
-        void process_buffer(const std::string& buffer);
+        void process_buffer(const std::string& buffer) { this->process_buffer(buffer.c_str(), buffer.c_str() + buffer.size()); }
+        // Process a block of G-code lines (for example a whole layer) in place, without copying it.
+        // The block has to be zero terminated at end.
+        void process_buffer(const char *begin, const char *end);
         void finalize(bool post_process);
 
         float get_time(PrintEstimatedStatistics::ETimeMode mode) const;
@@ -118,6 +118,8 @@ std::vector<float> raycast_visibility(
                     &raycasting_tree, &result, &samples, &params](tbb::blocked_range<size_t> r) {
                 // Maintaining hits memory outside of the loop, so it does not have to be reallocated for each query.
                 std::vector<igl::Hit> hits;
+                std::vector<Vec3d> ray_origins;
+                std::vector<Vec3d> ray_dirs;
                 for (size_t s_idx = r.begin(); s_idx < r.end(); ++s_idx) {
                     result[s_idx] = 1.0f;
                     const float decrease_step = 1.0f
@@ -129,20 +131,26 @@ std::vector<float> raycast_visibility(
                     Frame f;
                     f.set_from_z(normal);
 
-                    for (const auto &dir : precomputed_sample_directions) {
-                        Vec3f final_ray_dir = (f.to_world(dir));
-                        if (!model_contains_negative_parts) {
-                            igl::Hit hitpoint;
-                            // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
-                            // direction.
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            bool hit = AABBTreeIndirect::intersect_ray_first_hit(triangles.vertices,
-                                    triangles.indices, raycasting_tree, ray_origin_d, final_ray_dir_d, hitpoint);
-                            if (hit && its_face_normal(triangles, hitpoint.id).dot(final_ray_dir) <= 0) {
+                    if (!model_contains_negative_parts) {
+                        // All the rays of a sample share the origin, thus they are cast as a batch traversing
+                        // the AABB tree in packets.
+                        // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
+                        // direction.
+                        ray_origins.assign(precomputed_sample_directions.size(), (center + normal * 0.01f).cast<double>()); // start above surface.
+                        ray_dirs.clear();
+                        for (const auto &dir : precomputed_sample_directions)
+                            ray_dirs.emplace_back(f.to_world(dir).cast<double>());
+                        AABBTreeIndirect::intersect_rays_first_hit(triangles.vertices,
+                                triangles.indices, raycasting_tree, ray_origins, ray_dirs, hits);
+                        for (size_t ray_idx = 0; ray_idx < hits.size(); ++ray_idx) {
+                            const igl::Hit &hitpoint = hits[ray_idx];
+                            if (hitpoint.id != -1 && its_face_normal(triangles, hitpoint.id).dot(ray_dirs[ray_idx].cast<float>()) <= 0) {
                                 result[s_idx] -= decrease_step;
                             }
-                        } else { //TODO improve logic for order based boolean operations - consider order of volumes
+                        }
+                    } else { //TODO improve logic for order based boolean operations - consider order of volumes
+                        for (const auto &dir : precomputed_sample_directions) {
+                            Vec3f final_ray_dir = (f.to_world(dir));
                             bool casting_from_negative_volume = samples.triangle_indices[s_idx]
                                     >= negative_volumes_start_index;
 
@@ -203,10 +203,11 @@ LayerResult PressureEqualizer::process_layer(LayerResult &&input)
     m_gcode_lines.erase(m_gcode_lines.begin(), m_gcode_lines.begin() + int(next_layer_first_idx));
 
     if (output_buffer_length > 0)
-        prev_layer_result->gcode = std::string(output_buffer.data());
+        prev_layer_result->gcode.assign(output_buffer.data(), output_buffer_length);
 
     assert(!input.nop_layer_result || m_layer_results.empty());
-    LayerResult out = *prev_layer_result;
+    // Move the G-code out, the layer result is released anyway.
+    LayerResult out = std::move(*prev_layer_result);
     delete prev_layer_result;
     return out;
 }
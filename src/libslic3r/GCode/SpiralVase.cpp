@@ -23,7 +23,7 @@ static AABBTreeLines::LinesDistancer<Linef> get_layer_distancer(const std::vecto
     return AABBTreeLines::LinesDistancer{std::move(lines)};
 }
 
-std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
+std::string SpiralVase::process_layer(std::string &&gcode, bool last_layer)
 {
     /*  This post-processor relies on several assumptions:
         - all layers are processed through it, including those that are not supposed
@@ -37,23 +37,25 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
     // in order to update positions.
     if (!m_enabled) {
         m_reader.parse_buffer(gcode);
-        return gcode;
+        return std::move(gcode);
     }
 
+    // Parse the layer just once, store the lines together with their distances from the position of the reader
+    // before each line, so that the layer could be traversed twice without parsing it again.
     // Get total XY length for this layer by summing all extrusion moves.
     float total_layer_length = 0.f;
     float layer_height       = 0.f;
     float z                  = 0.f;
 
+    m_lines.clear();
     {
-        //FIXME Performance warning: This copies the GCodeConfig of the reader.
-        GCodeReader r = m_reader;  // clone
         bool set_z = false;
-        r.parse_buffer(gcode, [&total_layer_length, &layer_height, &z, &set_z]
+        m_reader.parse_buffer(gcode, [this, &total_layer_length, &layer_height, &z, &set_z]
             (GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+            ParsedLine &parsed = m_lines.emplace_back(ParsedLine{ line, line.dist_XY(reader), line.extruding(reader) });
             if (line.cmd_is("G1")) {
-                if (line.extruding(reader)) {
-                    total_layer_length += line.dist_XY(reader);
+                if (parsed.extruding) {
+                    total_layer_length += parsed.dist_XY;
                 } else if (line.has(Z)) {
                     layer_height += line.dist_Z(reader);
                     if (!set_z) {
@@ -79,21 +81,23 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
     const AABBTreeLines::LinesDistancer previous_layer_distancer = get_layer_distancer(m_previous_layer);
     Vec2f                               last_point               = m_previous_layer.empty() ? Vec2f::Zero() : m_previous_layer.back();
     float                               len                      = 0.f;
+    // GCodeLine::set() only queries the reader for the extrusion axis, the position of the reader is not used.
+    const GCodeReader                  &reader                   = m_reader;
 
     std::string        new_gcode, transition_gcode;
+    new_gcode.reserve(gcode.size());
     std::vector<Vec2f> current_layer;
-    m_reader.parse_buffer(gcode, [z, total_layer_length, layer_height, transition_in, transition_out, smooth_spiral, max_xy_smoothing = m_max_xy_smoothing,
-                                  &len, &last_point, &new_gcode, &transition_gcode, &current_layer, &previous_layer_distancer]
-        (GCodeReader &reader, GCodeReader::GCodeLine line) {
+    for (ParsedLine &parsed : m_lines) {
+        GCodeReader::GCodeLine &line = parsed.line;
         if (line.cmd_is("G1")) {
             if (line.has_z()) {
                 // If this is the initial Z move of the layer, replace it with a
                 // (redundant) move to the last Z of previous layer.
                 line.set(reader, Z, z);
                 new_gcode += line.raw() + '\n';
-                return;
+                continue;
             } else if (line.has_x() || line.has_y()) { // Sometimes lines have X/Y but the move is to the last position.
-                if (const float dist_XY = line.dist_XY(reader); dist_XY > 0 && line.extruding(reader)) { // Exclude wipe and retract
+                if (const float dist_XY = parsed.dist_XY; dist_XY > 0 && parsed.extruding) { // Exclude wipe and retract
                     len += dist_XY;
                     const float factor = len / total_layer_length;
                     if (transition_in)
@@ -118,7 +122,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                         current_layer.emplace_back(p); // Store that point for later use on the next layer
 
                         auto [nearest_distance, idx, nearest_pt] = previous_layer_distancer.distance_from_lines_extra<false>(p.cast<double>());
-                        if (nearest_distance < max_xy_smoothing) {
+                        if (nearest_distance < m_max_xy_smoothing) {
                             // Interpolate between the point on this layer and the point on the previous layer
                             Vec2f target = nearest_pt.cast<float>() * (1.f - factor) + p * factor;
 
@@ -140,7 +144,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                     if (emit_gcode_line)
                         new_gcode += line.raw() + '\n';
                 }
-                return;
+                continue;
                 /*  Skip travel moves: the move to first perimeter point will
                     cause a visible seam when loops are not aligned in XY; by skipping
                     it we blend the first loop move in the XY plane (although the smoothness
@@ -154,7 +158,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
         new_gcode += line.raw() + '\n';
         if (transition_out)
             transition_gcode += line.raw() + '\n';
-    });
+    }
 
     m_previous_layer = std::move(current_layer);
     return new_gcode + transition_gcode;
@@ -34,7 +34,8 @@ public:
         m_enabled          = enable;
     }
 
-    std::string process_layer(const std::string &gcode, bool last_layer);
+    // Returns the G-code of the layer unchanged if the spiral vase is not enabled for this layer.
+    std::string process_layer(std::string &&gcode, bool last_layer);
 
 private:
     const PrintConfig  &m_config;
@@ -47,6 +48,15 @@ private:
     // Whether to interpolate XY coordinates with the previous layer. Results in no seam at layer changes
     bool                m_smooth_spiral = true;
     std::vector<Vec2f>  m_previous_layer;
+
+    // Lines of the layer being processed, parsed once and kept to not reallocate the buffer for each layer.
+    struct ParsedLine {
+        GCodeReader::GCodeLine line;
+        // Distance in XY from the position before this line was applied.
+        float                  dist_XY;
+        bool                   extruding;
+    };
+    std::vector<ParsedLine> m_lines;
 };
 }
 
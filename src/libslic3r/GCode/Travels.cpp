@@ -75,16 +75,27 @@ std::pair<AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>, size_t> get_cur
     return {AABBTreeLines::LinesDistancer{std::move(lines)}, extrusion_entity_cnt};
 }
 
+TravelObstacleTracker::LayerDistancers TravelObstacleTracker::make_layer_distancers(const Layer &layer, const ObjectsLayerToPrint &objects_to_print)
+{
+    LayerDistancers out;
+    out.layer                    = &layer;
+    out.previous_layer_distancer = get_previous_layer_distancer(objects_to_print, layer.lower_layer->lslices);
+    std::tie(out.current_layer_distancer, out.extrusion_entity_cnt) = get_current_layer_distancer(objects_to_print);
+    return out;
+}
+
 void TravelObstacleTracker::init_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print)
 {
-    size_t extrusion_entity_cnt = 0;
     m_extruded_extrusion.clear();
 
-    m_objects_to_print         = objects_to_print;
-    m_previous_layer_distancer = get_previous_layer_distancer(m_objects_to_print, layer.lower_layer->lslices);
+    m_objects_to_print = objects_to_print;
+    LayerDistancers distancers = m_prepared_layer && m_prepared_layer->layer == &layer ?
+        std::move(*m_prepared_layer) : make_layer_distancers(layer, m_objects_to_print);
+    m_prepared_layer.reset();
 
-    std::tie(m_current_layer_distancer, extrusion_entity_cnt) = get_current_layer_distancer(m_objects_to_print);
-    m_extruded_extrusion.reserve(extrusion_entity_cnt);
+    m_previous_layer_distancer = std::move(distancers.previous_layer_distancer);
+    m_current_layer_distancer  = std::move(distancers.current_layer_distancer);
+    m_extruded_extrusion.reserve(distancers.extrusion_entity_cnt);
 }
 
 void TravelObstacleTracker::mark_extruded(const ExtrusionEntity *extrusion_entity, size_t object_layer_idx, size_t instance_idx)
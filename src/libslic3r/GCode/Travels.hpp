@@ -75,6 +75,21 @@ struct ExtrudedExtrusionEntityHash
 class TravelObstacleTracker
 {
 public:
+    // Line distancers of the obstacles around a layer. They only depend on the layers to print,
+    // thus they may be calculated in advance, for multiple layers in parallel.
+    struct LayerDistancers
+    {
+        const Layer                                          *layer = nullptr;
+        AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> previous_layer_distancer;
+        AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> current_layer_distancer;
+        size_t                                                extrusion_entity_cnt = 0;
+    };
+    static LayerDistancers make_layer_distancers(const Layer &layer, const ObjectsLayerToPrint &objects_to_print);
+
+    // Hand over the line distancers calculated in advance for the layer to be printed next.
+    void set_prepared_layer(std::optional<LayerDistancers> &&layer) { m_prepared_layer = std::move(layer); }
+
+    // Uses the line distancers handed over by set_prepared_layer() if they were calculated for this layer, calculates them otherwise.
     void init_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print);
 
     void mark_extruded(const ExtrusionEntity *extrusion_entity, size_t object_layer_idx, size_t instance_idx);
@@ -93,6 +108,7 @@ private:
 
     AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>                    m_current_layer_distancer;
     std::unordered_set<ExtrudedExtrusionEntity, ExtrudedExtrusionEntityHash> m_extruded_extrusion;
+    std::optional<LayerDistancers>                                           m_prepared_layer;
 };
 } // namespace Slic3r::GCode
 
@@ -7,15 +7,27 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/nowide/fstream.hpp>
 #include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/convert.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include "Utils.hpp"
 
 #include "LocalesUtils.hpp"
+#include "TBBPipeline.hpp"
+#include "Thread.hpp"
 
 #include <fast_float/fast_float.h>
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <memory>
+
 namespace Slic3r {
 
 static inline char get_extrusion_axis_char(const GCodeConfig &config)
@@ -38,10 +50,8 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
     m_extrusion_axis = get_extrusion_axis_char(m_config);
 }
 
-const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
+const char* GCodeReader::tokenize_line(const char *ptr, const char *end, float *axes, uint32_t &mask, std::pair<const char*, const char*> &command, const char *&line_end) const
 {
-    assert(is_decimal_separator_point());
-    
     // command and args
     const char *c = ptr;
     {
@@ -79,8 +89,8 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
                 if (pend != c && is_end_of_word(*pend)) {
                     // The axis value has been parsed correctly.
                     if (axis != UNKNOWN_AXIS)
-	                    gline.m_axis[int(axis)] = float(v);
-                    gline.m_mask |= 1 << int(axis);
+	                    axes[int(axis)] = float(v);
+                    mask |= 1 << int(axis);
                     c = pend;
                 } else
                     // Skip the rest of the word.
@@ -90,16 +100,10 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
                 c = skip_word(c);
         }
     }
-    
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
 
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
-
-    // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr)
-        gline.m_raw.assign(ptr, c);
+    line_end = c;
 
     // Skip the trailing newlines.
 	if (*c == '\r')
@@ -107,6 +111,23 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 	if (*c == '\n')
 		++ c;
 
+    return c;
+}
+
+const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
+{
+    assert(is_decimal_separator_point());
+
+    const char *line_end;
+    const char *c = this->tokenize_line(ptr, end, gline.m_axis, gline.m_mask, command, line_end);
+    
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
+    // Copy the raw string including the comment, without the trailing newlines.
+    if (line_end > ptr)
+        gline.m_raw.assign(ptr, line_end);
+
     if (m_verbose)
         std::cout << gline.m_raw << std::endl;
 
@@ -206,6 +227,150 @@ bool GCodeReader::parse_file(const std::string& file, callback_t callback, std::
     return this->parse_file_internal(file, callback, [&lines_ends](size_t file_pos) { lines_ends.front().emplace_back(file_pos); });
 }
 
+bool GCodeReader::parse_file_parallel(const std::string &filename, callback_t callback, std::vector<std::vector<size_t>> &lines_ends)
+{
+    lines_ends.clear();
+    lines_ends.push_back(std::vector<size_t>());
+
+#ifdef _WIN32
+    const boost::filesystem::path path(boost::nowide::widen(filename));
+#else
+    const boost::filesystem::path path(filename);
+#endif
+    boost::system::error_code ec;
+    const size_t file_size = size_t(boost::filesystem::file_size(path, ec));
+    if (ec)
+        return false;
+    // An empty file cannot be memory mapped.
+    boost::iostreams::mapped_file_source file;
+    if (file_size > 0) {
+        try {
+            file.open(path);
+        } catch (const std::exception &ex) {
+            BOOST_LOG_TRIVIAL(error) << "GCodeReader::parse_file_parallel: Couldn't open " << filename << " for reading: " << ex.what();
+            return false;
+        }
+    }
+    const char *data = file_size > 0 ? file.data() : nullptr;
+
+    // Line parsed by tokenize_line(), referencing its raw text in the block.
+    struct TokenizedLine {
+        uint32_t begin;
+        uint32_t end;
+        uint32_t mask;
+        float    axis[NUM_AXES];
+    };
+    // Block of whole lines of the memory mapped file.
+    struct Block {
+        const char                *begin { nullptr };
+        const char                *end   { nullptr };
+        // Zero terminated copy of the last block if the file does not end with a new line,
+        // as tokenize_line() relies on the line being terminated.
+        std::vector<char>          buffer;
+        size_t                     file_pos { 0 };
+        std::vector<TokenizedLine> lines;
+        std::vector<size_t>        lines_ends;
+    };
+
+    // Split the file into 4MB blocks. The block is cut after the last new line, the rest is moved to the next block.
+    static constexpr const size_t block_size = 4 * 1024 * 1024;
+    size_t            file_pos   = 0;
+    // Set by the serial stage if the callback wishes to exit, read by the input stage.
+    std::atomic<bool> stop       { false };
+    m_parsing = true;
+
+    auto reader = tbb::make_filter<void, std::shared_ptr<Block>>(slic3r_tbb_filtermode::serial_in_order,
+        [data, file_size, &file_pos, &stop](tbb::flow_control &fc) -> std::shared_ptr<Block> {
+            if (file_pos == file_size || stop) {
+                fc.stop();
+                return {};
+            }
+            size_t cut = std::min(file_pos + block_size, file_size);
+            if (cut < file_size) {
+                if (auto it = std::find(std::make_reverse_iterator(data + cut), std::make_reverse_iterator(data + file_pos), '\n');
+                    it.base() != data + file_pos)
+                    cut = it.base() - data;
+                else
+                    // A single line longer than the block, extend the block up to the end of the line.
+                    cut = std::min(size_t(std::find(data + cut, data + file_size, '\n') - data) + 1, file_size);
+            }
+            if (cut - file_pos > std::numeric_limits<uint32_t>::max())
+                throw Slic3r::RuntimeError("G-code line too long");
+            auto block = std::make_shared<Block>();
+            block->file_pos = file_pos;
+            block->begin    = data + file_pos;
+            block->end      = data + cut;
+            if (cut == file_size && data[cut - 1] != '\n') {
+                block->buffer.reserve(cut - file_pos + 1);
+                block->buffer.assign(block->begin, block->end);
+                block->buffer.emplace_back(0);
+                block->begin = block->buffer.data();
+                block->end   = block->begin + block->buffer.size() - 1;
+            }
+            file_pos = cut;
+            return block;
+        });
+
+    auto tokenizer = tbb::make_filter<std::shared_ptr<Block>, std::shared_ptr<Block>>(slic3r_tbb_filtermode::parallel,
+        [this](std::shared_ptr<Block> block) -> std::shared_ptr<Block> {
+            const char *begin = block->begin;
+            const char *end   = block->end;
+            for (const char *c = begin; c != end; ++ c)
+                if (*c == '\n')
+                    block->lines_ends.emplace_back(block->file_pos + (c - begin) + 1);
+            block->lines.reserve(block->lines_ends.size() + 1);
+            for (const char *ptr = begin; ptr != end;) {
+                TokenizedLine &line = block->lines.emplace_back();
+                line.mask = 0;
+                memset(line.axis, 0, sizeof(line.axis));
+                std::pair<const char*, const char*> command;
+                const char *line_end;
+                const char *next = this->tokenize_line(ptr, end, line.axis, line.mask, command, line_end);
+                if (next != end && *next == 0) {
+                    // Zero character inside the line. Ignore the rest of the line the same way parse_file() does.
+                    for (; next != end && ! (*next == '\r' || *next == '\n'); ++ next) ;
+                    if (next != end && *next == '\r')
+                        ++ next;
+                    if (next != end && *next == '\n')
+                        ++ next;
+                }
+                line.begin = uint32_t(ptr - begin);
+                line.end   = uint32_t(line_end - begin);
+                ptr = next;
+            }
+            return block;
+        });
+
+    auto consumer = tbb::make_filter<std::shared_ptr<Block>, void>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &callback, &lines_ends, &stop](std::shared_ptr<Block> block) {
+            if (stop)
+                return;
+            append(lines_ends.front(), std::move(block->lines_ends));
+            GCodeLine gline;
+            for (const TokenizedLine &line : block->lines) {
+                gline.m_mask = line.mask;
+                memcpy(gline.m_axis, line.axis, sizeof(gline.m_axis));
+                gline.m_raw.assign(block->begin + line.begin, block->begin + line.end);
+                if (gline.has(E) && m_config.use_relative_e_distances)
+                    m_position[E] = 0;
+                callback(*this, gline);
+                const std::string_view cmd = gline.cmd();
+                std::pair<const char*, const char*> command { cmd.data(), cmd.data() + cmd.size() };
+                update_coordinates(gline, command);
+                if (! m_parsing) {
+                    // The callback wishes to exit.
+                    stop = true;
+                    return;
+                }
+            }
+        });
+
+    // It registers a handler that sets locales to "C" before any TBB thread starts participating in tbb::parallel_pipeline.
+    TBBLocalesSetter locales_setter;
+    tbb::parallel_pipeline(16, reader & tokenizer & consumer);
+    return true;
+}
+
 bool GCodeReader::parse_file_raw(const std::string &filename, raw_line_callback_t line_callback)
 {
     return this->parse_file_raw_internal(filename,
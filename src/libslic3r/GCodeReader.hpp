@@ -106,19 +106,23 @@ public:
     void apply_config(const GCodeConfig &config);
     void apply_config(const DynamicPrintConfig &config);
 
+    // Parse a block of G-code lines in place. The block has to be zero terminated at end.
     template<typename Callback>
-    void parse_buffer(const std::string &buffer, Callback callback)
+    void parse_buffer(const char *ptr, const char *end, Callback callback)
     {
-        const char *ptr = buffer.c_str();
-        const char *end = ptr + buffer.size();
+        assert(*end == 0);
         GCodeLine gline;
         m_parsing = true;
-        while (m_parsing && *ptr != 0) {
+        while (m_parsing && ptr != end && *ptr != 0) {
             gline.reset();
             ptr = this->parse_line(ptr, end, gline, callback);
         }
     }
 
+    template<typename Callback>
+    void parse_buffer(const std::string &buffer, Callback callback)
+        { this->parse_buffer(buffer.c_str(), buffer.c_str() + buffer.size(), callback); }
+
     void parse_buffer(const std::string &buffer)
         { this->parse_buffer(buffer, [](GCodeReader&, const GCodeReader::GCodeLine&){}); }
 
@@ -141,6 +145,9 @@ public:
     // Collect positions of line ends in the binary G-code to be used by the G-code viewer when memory mapping and displaying section of G-code
     // as an overlay in the 3D scene.
     bool parse_file(const std::string& file, callback_t callback, std::vector<std::vector<size_t>>& lines_ends);
+    // Same as parse_file() with lines_ends, but the file is read in large blocks, which are tokenized in parallel.
+    // Only the callback and the update of the current position are executed serially, in the order of the lines.
+    bool parse_file_parallel(const std::string &file, callback_t callback, std::vector<std::vector<size_t>> &lines_ends);
     // Just read the G-code file line by line, calls callback (const char *begin, const char *end). Returns false if reading the file failed.
     bool parse_file_raw(const std::string &file, raw_line_callback_t callback);
 
@@ -171,6 +178,9 @@ private:
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Parse the command and axes of a single line without copying the raw line and without modifying the state of the reader,
+    // thus it may be called from multiple threads. Returns end of the line in line_end and the start of the next line.
+    const char* tokenize_line(const char *ptr, const char *end, float *axis, uint32_t &mask, std::pair<const char*, const char*> &command, const char *&line_end) const;
     void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
@@ -10,11 +10,16 @@
 #include "Exception.hpp"
 #include "Flow.hpp"
 #include "Utils.hpp"
+#include <algorithm>
 #include <cstring>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 #ifdef _MSC_VER
     #include <stdlib.h>  // provides **_environ
 #else
@@ -800,6 +805,8 @@ namespace client
         // If false, the macro_processor will evaluate a full macro.
         // If true, the macro processor will evaluate just a boolean condition using the full expressive power of the macro processor.
         bool                     just_boolean_expression = false;
+        // Full template, if the parser is fed just a part of it. Errors are reported relative to the full template.
+        const std::string       *templ                  = nullptr;
         std::string              error_message;
 
         // Table to translate symbol tag to a human readable error message.
@@ -1570,8 +1577,10 @@ namespace client
             boost::throw_exception(qi::expectation_failure(it_range.begin(), it_range.end(), spirit::info(std::string("*") + msg)));
         }
 
-        static void process_error_message(const MyContext *context, const boost::spirit::info &info, const Iterator &it_begin, const Iterator &it_end, const Iterator &it_error)
+        static void process_error_message(const MyContext *context, const boost::spirit::info &info, const Iterator &it_begin_parsed, const Iterator &it_end_parsed, const Iterator &it_error)
         {
+            const Iterator it_begin = context->templ ? context->templ->begin() : it_begin_parsed;
+            const Iterator it_end   = context->templ ? context->templ->end()   : it_end_parsed;
             std::string &msg = const_cast<MyContext*>(context)->error_message;
             std::string  first(it_begin, it_error);
             std::string  last(it_error, it_end);
@@ -2338,15 +2347,202 @@ namespace client
 
 static const client::macro_processor g_macro_processor_instance;
 
-static std::string process_macro(const std::string &templ, client::MyContext &context)
+static void throw_on_error(client::MyContext &context)
 {
-    std::string output;
-    phrase_parse(templ.begin(), templ.end(), g_macro_processor_instance(&context), client::skipper{}, output);
 	if (! context.error_message.empty()) {
         if (context.error_message.back() != '\n' && context.error_message.back() != '\r')
             context.error_message += '\n';
         throw Slic3r::PlaceholderParserError(context.error_message);
     }
+}
+
+static std::string process_macro(const std::string &templ, client::MyContext &context)
+{
+    std::string output;
+    phrase_parse(templ.begin(), templ.end(), g_macro_processor_instance(&context), client::skipper{}, output);
+    throw_on_error(context);
+    return output;
+}
+
+// A template split into top level segments once, so that the plain text and the legacy variable expansions
+// are not run through the grammar every time the template is processed.
+struct CompiledTemplate
+{
+    enum class SegmentType {
+        // Copied to the output verbatim.
+        Text,
+        // Identifier of a legacy [variable] expansion.
+        LegacyVariable,
+        // Parsed by the macro processor grammar.
+        Macro,
+    };
+    struct Segment {
+        SegmentType type;
+        // Range of the segment in the template.
+        size_t      begin;
+        size_t      end;
+    };
+    std::vector<Segment> segments;
+};
+
+static bool is_identifier_start(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+static bool is_identifier_char(char c) { return is_identifier_start(c) || (c >= '0' && c <= '9'); }
+
+// Length of the UTF-8 sequence at pos as validated by utf8_char_parser, zero if the grammar would reject it.
+static size_t utf8_sequence_length(const std::string &templ, size_t pos)
+{
+    unsigned char c = static_cast<unsigned char>(templ[pos]);
+    if ((c & 0xC0) == 0x80)
+        return 0;
+    unsigned int cnt = 0;
+    for (unsigned char mask = 0x80u; c & mask; mask >>= 1)
+        ++ cnt;
+    cnt = (cnt == 0) ? 1 : std::min(cnt, 4u);
+    size_t end = pos + 1;
+    for (-- cnt; cnt > 0; -- cnt) {
+        if (end == templ.size())
+            return 0;
+        c = static_cast<unsigned char>(templ[end ++]);
+        if (cnt > 1 && (c & 0xC0) != 0x80)
+            return 0;
+    }
+    return end - pos;
+}
+
+static CompiledTemplate compile_template(const std::string &templ)
+{
+    using SegmentType = CompiledTemplate::SegmentType;
+    CompiledTemplate out;
+    auto identifier_end = [&templ](size_t pos) {
+        if (pos < templ.size() && is_identifier_start(templ[pos]))
+            while (++ pos < templ.size() && is_identifier_char(templ[pos])) ;
+        return pos;
+    };
+    auto is_keyword = [](const std::string_view id, std::initializer_list<std::string_view> keywords) {
+        return std::find(keywords.begin(), keywords.end(), id) != keywords.end();
+    };
+    // Segments are only split off where it is certain that the grammar would parse them as separate top level text_block items.
+    // Anything else, for example an {if} block spanning text or a macro with string or regular expression literals, is left
+    // to the grammar together with the rest of the template.
+    size_t pos = 0;
+    while (pos < templ.size()) {
+        const char c = templ[pos];
+        if (c == '{') {
+            const size_t end = templ.find('}', pos + 1);
+            if (end == std::string::npos)
+                break;
+            bool simple = true;
+            for (size_t i = pos + 1; simple && i < end;)
+                if (templ[i] == '{' || templ[i] == '"' || templ[i] == '/')
+                    simple = false;
+                else if (is_identifier_start(templ[i])) {
+                    size_t id_end = identifier_end(i);
+                    simple = ! is_keyword(std::string_view(templ.data() + i, id_end - i), { "if", "elsif", "else", "endif" });
+                    i = id_end;
+                } else if (is_identifier_char(templ[i])) {
+                    // Skip numbers, so that their exponent is not considered an identifier.
+                    while (++ i < end && is_identifier_char(templ[i])) ;
+                } else
+                    ++ i;
+            if (! simple)
+                break;
+            out.segments.push_back({ SegmentType::Macro, pos, end + 1 });
+            pos = end + 1;
+        } else if (c == '[') {
+            const size_t id_end = identifier_end(pos + 1);
+            if (id_end == pos + 1 || id_end == templ.size())
+                break;
+            if (templ[id_end] == ']') {
+                // The grammar does not accept keywords as identifiers, let it report the error.
+                if (is_keyword(std::string_view(templ.data() + pos + 1, id_end - pos - 1), 
+                        { "and", "digits", "zdigits", "empty", "if", "int", "is_nil", "local", "else", "elsif", "endif", "false", "global",
+                          "interpolate_table", "min", "max", "random", "repeat", "round", "not", "one_of", "or", "size", "true" }))
+                    break;
+                out.segments.push_back({ SegmentType::LegacyVariable, pos + 1, id_end });
+                pos = id_end + 1;
+            } else if (templ[id_end] == '[') {
+                // [vector_variable[index_variable]]
+                const size_t idx_end = identifier_end(id_end + 1);
+                if (idx_end == id_end + 1 || idx_end + 1 >= templ.size() || templ[idx_end] != ']' || templ[idx_end + 1] != ']')
+                    break;
+                out.segments.push_back({ SegmentType::Macro, pos, idx_end + 2 });
+                pos = idx_end + 2;
+            } else
+                break;
+        } else {
+            size_t end = pos;
+            while (end < templ.size() && templ[end] != '[' && templ[end] != '{') {
+                const size_t len = utf8_sequence_length(templ, end);
+                if (len == 0) {
+                    // Let the grammar report the invalid UTF-8 sequence.
+                    out.segments.clear();
+                    pos = 0;
+                    goto done;
+                }
+                end += len;
+            }
+            // The grammar skips white space and rejects non-ASCII characters at the very start of the template.
+            const unsigned char c0 = static_cast<unsigned char>(c);
+            const bool skipped = pos == 0 && (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c0 >= 0x80);
+            out.segments.push_back({ skipped ? SegmentType::Macro : SegmentType::Text, pos, end });
+            pos = end;
+        }
+    }
+done:
+    if (pos < templ.size())
+        out.segments.push_back({ SegmentType::Macro, pos, templ.size() });
+    return out;
+}
+
+// The custom G-code templates are processed repeatedly, for example for every layer. Compile each template just once.
+static std::shared_ptr<const CompiledTemplate> compiled_template(const std::string &templ)
+{
+    static std::mutex                                                              mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>> cache;
+    std::scoped_lock<std::mutex> lock(mutex);
+    if (auto it = cache.find(templ); it != cache.end())
+        return it->second;
+    if (cache.size() >= 1024)
+        // Don't let the cache grow indefinitely, for example when editing the templates in the UI.
+        cache.clear();
+    return cache.emplace(templ, std::make_shared<const CompiledTemplate>(compile_template(templ))).first->second;
+}
+
+static std::string process_compiled_macro(const std::string &templ, const CompiledTemplate &compiled, client::MyContext &context)
+{
+    using SegmentType = CompiledTemplate::SegmentType;
+    context.templ = &templ;
+    std::string output;
+    for (const CompiledTemplate::Segment &segment : compiled.segments) {
+        const auto begin = templ.begin() + segment.begin;
+        const auto end   = templ.begin() + segment.end;
+        switch (segment.type) {
+        case SegmentType::Text:
+            output.append(begin, end);
+            break;
+        case SegmentType::LegacyVariable:
+        {
+            std::string           value;
+            client::IteratorRange opt_key(begin, end);
+            try {
+                client::MyContext::legacy_variable_expansion(&context, opt_key, value);
+            } catch (const qi::expectation_failure<client::Iterator> &ex) {
+                client::MyContext::process_error_message(&context, ex.what_, templ.begin(), templ.end(), ex.first);
+            }
+            throw_on_error(context);
+            output += value;
+            break;
+        }
+        case SegmentType::Macro:
+        {
+            std::string value;
+            phrase_parse(begin, end, g_macro_processor_instance(&context), client::skipper{}, value);
+            throw_on_error(context);
+            output += value;
+            break;
+        }
+        }
+    }
     return output;
 }
 
@@ -2359,7 +2555,7 @@ std::string PlaceholderParser::process(const std::string &templ, unsigned int cu
     context.config_outputs      = config_outputs;
     context.current_extruder_id = current_extruder_id;
     context.context_data        = context_data;
-    return process_macro(templ, context);
+    return process_compiled_macro(templ, *compiled_template(templ), context);
 }
 
 // Evaluate a boolean expression using the full expressive power of the PlaceholderParser boolean expression syntax.
@@ -969,30 +969,48 @@ void Print::process()
 
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
-        for (size_t idx = range.begin(); idx < range.end(); ++idx) {
-            m_objects[idx]->make_perimeters();
-            m_objects[idx]->infill();
-            m_objects[idx]->ironing();
+    // Steps of a PrintObject only depend on the preceding steps of the same PrintObject, thus each PrintObject is processed
+    // from the perimeters to the overhangs without waiting for the others. A small object does not wait for a large one this way.
+    // PrintObjects of the same ModelObject share their m_shared_regions, into which generate_support_spots() writes,
+    // so these are processed together and their support spots are searched sequentially.
+    std::vector<std::vector<PrintObject*>> object_groups;
+    for (PrintObject *obj : m_objects) {
+        auto it = std::find_if(object_groups.begin(), object_groups.end(),
+            [obj](const std::vector<PrintObject*> &group) { return group.front()->shared_regions() == obj->shared_regions(); });
+        if (it == object_groups.end())
+            object_groups.push_back({ obj });
+        else
+            it->emplace_back(obj);
+    }
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, object_groups.size(), 1), [&object_groups](const tbb::blocked_range<size_t> &range) {
+        for (size_t group_idx = range.begin(); group_idx < range.end(); ++ group_idx) {
+            const std::vector<PrintObject*> &objects = object_groups[group_idx];
+            auto for_each_object = [&objects](auto &&fn) {
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, objects.size(), 1), [&objects, &fn](const tbb::blocked_range<size_t> &range) {
+                    for (size_t idx = range.begin(); idx < range.end(); ++ idx)
+                        fn(*objects[idx]);
+                }, tbb::simple_partitioner());
+            };
+            for_each_object([](PrintObject &obj) {
+                obj.make_perimeters();
+                obj.infill();
+                obj.ironing();
+            });
+            for (PrintObject *obj : objects)
+                obj->generate_support_spots();
+            for_each_object([](PrintObject &obj) {
+                obj.generate_support_material();
+                obj.estimate_curled_extrusions();
+                obj.calculate_overhanging_perimeters();
+            });
         }
     }, tbb::simple_partitioner());
 
-    // The following step writes to m_shared_regions, it should not run in parallel.
-    for (PrintObject *obj : m_objects)
-        obj->generate_support_spots();
-    // check data from previous step, format the error message(s) and send alert to ui
-    // this also has to be done sequentially.
+    // check data from the support spots search of all objects, format the error message(s) and send alert to ui
+    // this has to be done sequentially.
     alert_when_supports_needed();
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
-        for (size_t idx = range.begin(); idx < range.end(); ++idx) {
-            PrintObject &obj = *m_objects[idx];
-            obj.generate_support_material();
-            obj.estimate_curled_extrusions();
-            obj.calculate_overhanging_perimeters();
-        }
-    }, tbb::simple_partitioner());
-
     if (this->set_started(psWipeTower)) {
         m_wipe_tower_data.clear();
         m_tool_ordering.clear();
@@ -43,6 +43,7 @@
 #include <Eigen/Geometry>
 
 #include <functional>
+#include <limits>
 #include <optional>
 #include <set>
 #include <tcbspan/span.hpp>
@@ -379,6 +380,11 @@ private:
     // It may be called for both the PrintObjectConfig and PrintRegionConfig.
     bool                    invalidate_state_by_config_options(
         const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys);
+    // Invalidate steps based on a set of parameters changed of a PrintRegion, which is only used by layers with slice_z inside layer_height_range.
+    // Steps working on each layer independently are only invalidated for these layers.
+    bool                    invalidate_state_by_config_options(
+        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+        const t_layer_height_range &layer_height_range);
     // If ! m_slicing_params.valid, recalculate.
     void                    update_slicing_parameters();
 
@@ -391,6 +397,9 @@ private:
     void make_perimeters();
     void prepare_infill();
     void clear_fills();
+    // Invalidates posInfill and posIroning just for the layers with slice_z inside layer_height_range.
+    bool invalidate_fills(const t_layer_height_range &layer_height_range);
+    bool layer_fill_invalid(const Layer &layer) const;
     void infill();
     void ironing();
     void generate_support_spots();
@@ -434,6 +443,10 @@ private:
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                    				m_typed_slices = false;
+    // Range of Layer::slice_z, for which posInfill and posIroning are to be recalculated.
+    // Narrower than the whole object only if the infill was invalidated by a change of a layer range modifier.
+    // Empty (first > second) once both steps are done.
+    t_layer_height_range                    m_fills_invalid_range { 0., std::numeric_limits<coordf_t>::max() };
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
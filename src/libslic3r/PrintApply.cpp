@@ -5,6 +5,7 @@
 #include "Model.hpp"
 #include "Print.hpp"
 
+#include <algorithm>
 #include <cfloat>
 
 namespace Slic3r {
@@ -645,12 +646,26 @@ PrintObjectRegions::BoundingBox find_modifier_volume_extents(const PrintObjectRe
 
 PrintRegionConfig region_config_from_model_volume(const PrintRegionConfig &default_or_parent_region_config, const DynamicPrintConfig *layer_range_config, const ModelVolume &volume, size_t num_extruders);
 
+// Span of the layer ranges referencing a PrintRegion.
+static t_layer_height_range print_region_layer_height_range(const PrintObjectRegions &print_object_regions, const PrintRegion &region)
+{
+    t_layer_height_range out { DBL_MAX, 0. };
+    for (const PrintObjectRegions::LayerRangeRegions &layer_range : print_object_regions.layer_ranges)
+        if (std::any_of(layer_range.volume_regions.begin(), layer_range.volume_regions.end(), [&region](const PrintObjectRegions::VolumeRegion &r){ return r.region == &region; }) ||
+            std::any_of(layer_range.painted_regions.begin(), layer_range.painted_regions.end(), [&region](const PrintObjectRegions::PaintedRegion &r){ return r.region == &region; })) {
+            out.first  = std::min(out.first,  layer_range.layer_height_range.first);
+            out.second = std::max(out.second, layer_range.layer_height_range.second);
+        }
+    return out;
+}
+
 void print_region_ref_inc(PrintRegion &r) { ++ r.m_ref_cnt; }
 void print_region_ref_reset(PrintRegion &r) { r.m_ref_cnt = 0; }
 int  print_region_ref_cnt(const PrintRegion &r) { return r.m_ref_cnt; }
 
 // Verify whether the PrintRegions of a PrintObject are still valid, possibly after updating the region configs.
 // Before region configs are updated, callback_invalidate() is called to possibly stop background processing.
+// callback_invalidate() receives the span of the layer ranges using the updated region.
 // Returns false if this object needs to be resliced because regions were merged or split.
 bool verify_update_print_object_regions(
     ModelVolumePtrs                     model_volumes,
@@ -658,7 +673,7 @@ bool verify_update_print_object_regions(
     size_t                              num_extruders,
     const std::vector<unsigned int>    &painting_extruders,
     PrintObjectRegions                 &print_object_regions,
-    const std::function<void(const PrintRegionConfig&, const PrintRegionConfig&, const t_config_option_keys&)> &callback_invalidate)
+    const std::function<void(const PrintRegionConfig&, const PrintRegionConfig&, const t_config_option_keys&, const t_layer_height_range&)> &callback_invalidate)
 {
     // Sort by ModelVolume ID.
     model_volumes_sort_by_id(model_volumes);
@@ -719,7 +734,7 @@ bool verify_update_print_object_regions(
                         // Region is referenced for the first time. Just change its parameters.
                         // Stop the background process before assigning new configuration to the regions.
                         t_config_option_keys diff = region.region->config().diff(cfg);
-                        callback_invalidate(region.region->config(), cfg, diff);
+                        callback_invalidate(region.region->config(), cfg, diff, print_region_layer_height_range(print_object_regions, *region.region));
                         region.region->config_apply_only(cfg, diff, false);
                     } else {
                         // Region is referenced multiple times, thus the region is being split. We need to reslice.
@@ -744,7 +759,7 @@ bool verify_update_print_object_regions(
                     // Region is referenced for the first time. Just change its parameters.
                     // Stop the background process before assigning new configuration to the regions.
                     t_config_option_keys diff = region.region->config().diff(cfg);
-                    callback_invalidate(region.region->config(), cfg, diff);
+                    callback_invalidate(region.region->config(), cfg, diff, print_region_layer_height_range(print_object_regions, *region.region));
                     region.region->config_apply_only(cfg, diff, false);
                 } else {
                     // Region is referenced multiple times, thus the region is being split. We need to reslice.
@@ -1410,10 +1425,10 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                     num_extruders,
                     painting_extruders,
                     *print_object_regions,
-                    [it_print_object, it_print_object_end, &update_apply_status](const PrintRegionConfig &old_config, const PrintRegionConfig &new_config, const t_config_option_keys &diff_keys) {
+                    [it_print_object, it_print_object_end, &update_apply_status](const PrintRegionConfig &old_config, const PrintRegionConfig &new_config, const t_config_option_keys &diff_keys, const t_layer_height_range &layer_height_range) {
                         for (auto it = it_print_object; it != it_print_object_end; ++it)
                             if ((*it)->m_shared_regions != nullptr)
-                                update_apply_status((*it)->invalidate_state_by_config_options(old_config, new_config, diff_keys));
+                                update_apply_status((*it)->invalidate_state_by_config_options(old_config, new_config, diff_keys, layer_height_range));
                     })) {
                 // Regions are valid, just keep them.
             } else {
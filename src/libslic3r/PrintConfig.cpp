@@ -194,6 +194,12 @@ static const t_config_enum_values s_keys_map_SLADisplayOrientation = {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLADisplayOrientation)
 
+static const t_config_enum_values s_keys_map_SLARasterizer = {
+    { "agg",            slarAGG},
+    { "scanline",       slarScanline}
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLARasterizer)
+
 static const t_config_enum_values s_keys_map_SLAPillarConnectionMode = {
     {"zigzag",          int(SLAPillarConnectionMode::zigzag)},
     {"cross",           int(SLAPillarConnectionMode::cross)},
@@ -4482,6 +4488,19 @@ void PrintConfigDef::init_sla_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionFloat(0.001));
 
+    def = this->add("sla_rasterizer", coEnum);
+    def->label = L("Rasterizer");
+    def->tooltip = L("Algorithm rasterizing the layers into the images of the SLA archive. "
+                     "AGG fills the polygons of a layer one by one, Scanline fills the whole "
+                     "layer at once and is faster for layers with many support cross sections. "
+                     "Both produce the same images up to rounding of the anti-aliased pixels.");
+    def->set_enum<SLARasterizer>({
+        { "agg",        L("AGG") },
+        { "scanline",   L("Scanline") }
+    });
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionEnum<SLARasterizer>(slarAGG));
+
     // Declare retract values for material profile, overriding the print and printer profiles.
     for (const char* opt_key : {
         // float
@@ -5464,6 +5483,19 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->cli = "slice|s";
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("serve", coString);
+    def->label = L("Slicing service");
+    def->tooltip = L("Run as a slicing service listening on the given local socket. Each line received is a JSON request "
+                     "with the \"model\" file to slice, optional \"output\" file and \"config\" object of configuration values "
+                     "overriding the loaded configuration. Each request is answered by a line with a JSON response. "
+                     "The loaded models and their slicing results are kept between the requests, "
+                     "so that just the steps affected by the changed configuration values are recalculated. "
+                     "Only one client is served at a time, the next connection is accepted once the client closes its connection. "
+                     "Project files with a configuration and the transform options other than --dont-arrange and --ensure-on-bed are not supported. "
+                     "The service is stopped by the {\"command\": \"shutdown\"} request.");
+    def->cli = "serve";
+    def->set_default_value(new ConfigOptionString());
+
     def = this->add("help", coBool);
     def->label = L("Help");
     def->tooltip = L("Show this help.");
@@ -5615,7 +5647,8 @@ CLIMiscConfigDef::CLIMiscConfigDef()
 
     def = this->add("output", coString);
     def->label = L("Output File");
-    def->tooltip = L("The file where the output will be written (if not specified, it will be based on the input file).");
+    def->tooltip = L("The file where the output will be written (if not specified, it will be based on the input file). "
+                     "When slicing, a file name containing placeholders is processed for each input file the same way as output_filename_format.");
     def->cli = "output|o";
 
     def = this->add("single_instance", coBool);
@@ -5633,6 +5666,21 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = L("Sets the maximum number of threads the slicing process will use. If not defined, it will be decided automatically.");
     def->min = 1;
 
+    def = this->add("batch_jobs", coInt);
+    def->label = L("Number of models sliced concurrently");
+    def->tooltip = L("When slicing multiple input files, slice up to this number of them at the same time. "
+                     "The slicing jobs share the threads of the slicing process. Useful for slicing many small models. "
+                     "If more than one job is running, --output has to be a directory or a file name template "
+                     "with placeholders, for example {input_filename_base}.gcode.");
+    def->min = 1;
+    def->set_default_value(new ConfigOptionInt(1));
+
+    def = this->add("batch_report", coString);
+    def->label = L("Batch report file");
+    def->tooltip = L("Write a JSON report of the sliced input files to this file, listing the output file, "
+                     "slicing time, peak memory usage of the process and errors for each input file.");
+    def->set_default_value(new ConfigOptionString());
+
     def = this->add("loglevel", coInt);
     def->label = L("Logging level");
     def->tooltip = L("Sets logging sensitivity. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n"
@@ -420,7 +420,13 @@ void PrintObject::prepare_infill()
 void PrintObject::clear_fills()
 {
     for (Layer *layer : m_layers)
-        layer->clear_fills();
+        if (this->layer_fill_invalid(*layer))
+            layer->clear_fills();
+}
+
+bool PrintObject::layer_fill_invalid(const Layer &layer) const
+{
+    return layer.slice_z > m_fills_invalid_range.first - EPSILON && layer.slice_z < m_fills_invalid_range.second + EPSILON;
 }
 
 void PrintObject::infill()
@@ -441,7 +447,8 @@ void PrintObject::infill()
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get(), this->m_lightning_generator.get());
+                    if (this->layer_fill_invalid(*m_layers[layer_idx]))
+                        m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get(), this->m_lightning_generator.get());
                 }
             }
         );
@@ -465,12 +472,16 @@ void PrintObject::ironing()
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_ironing();
+                    if (this->layer_fill_invalid(*m_layers[layer_idx]))
+                        m_layers[layer_idx]->make_ironing();
                 }
             }
         );
         m_print->throw_if_canceled();
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - end";
+        // Both the infill and the ironing are valid for all layers now, the range of layers to be refilled is empty.
+        // Reset before set_done() publishes the step, so that invalidate_fills() never extends a stale range.
+        m_fills_invalid_range = { std::numeric_limits<coordf_t>::max(), 0. };
         this->set_done(posIroning);
     }
 }
@@ -694,6 +705,13 @@ SupportLayerPtrs::iterator PrintObject::insert_support_layer(SupportLayerPtrs::i
 // This method only accepts PrintObjectConfig and PrintRegionConfig option keys.
 bool PrintObject::invalidate_state_by_config_options(
     const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys)
+{
+    return this->invalidate_state_by_config_options(old_config, new_config, opt_keys, { 0., std::numeric_limits<coordf_t>::max() });
+}
+
+bool PrintObject::invalidate_state_by_config_options(
+    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+    const t_layer_height_range &layer_height_range)
 {
     if (opt_keys.empty())
         return false;
@@ -908,13 +926,33 @@ bool PrintObject::invalidate_state_by_config_options(
 
     sort_remove_duplicates(steps);
     for (PrintObjectStep step : steps)
-        invalidated |= this->invalidate_step(step);
+        // Infill is generated for each layer independently, thus only the layers of layer_height_range need to be refilled.
+        invalidated |= step == posInfill ? this->invalidate_fills(layer_height_range) : this->invalidate_step(step);
+    return invalidated;
+}
+
+bool PrintObject::invalidate_fills(const t_layer_height_range &layer_height_range)
+{
+    if (layer_height_range.first <= 0. && layer_height_range.second >= std::numeric_limits<coordf_t>::max())
+        return this->invalidate_step(posInfill);
+
+    // First call the "invalidate" functions, which may cancel background processing.
+    // Same as invalidate_step(posInfill), but ironing is done for each layer independently as well.
+    bool invalidated = this->invalidate_steps({ posInfill, posIroning, posSupportSpotsSearch });
+    invalidated |= m_print->invalidate_steps({ psSkirtBrim, psAlertWhenSupportsNeeded, psWipeTower, psGCodeExport });
+    // Then extend the range of layers to be refilled, which is empty if the fills of all layers were valid.
+    m_fills_invalid_range.first  = std::min(m_fills_invalid_range.first,  layer_height_range.first);
+    m_fills_invalid_range.second = std::max(m_fills_invalid_range.second, layer_height_range.second);
     return invalidated;
 }
 
 bool PrintObject::invalidate_step(PrintObjectStep step)
 {
 	bool invalidated = Inherited::invalidate_step(step);
+
+    if (step <= posIroning)
+        // The step invalidates the infill of all layers.
+        m_fills_invalid_range = { 0., std::numeric_limits<coordf_t>::max() };
     
     // propagate to dependent steps
     if (step == posPerimeters) {
@@ -953,6 +991,7 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+    m_fills_invalid_range = { 0., std::numeric_limits<coordf_t>::max() };
 	return result;
 }
 
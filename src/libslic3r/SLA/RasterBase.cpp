@@ -10,6 +10,7 @@
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
+#include <libslic3r/SLA/ScanlineRaster.hpp>
 
 // minz image write:
 #include <miniz.h>
@@ -71,11 +72,14 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     const Resolution        &res,
     const PixelDim          &pxdim,
     double                   gamma,
-    const RasterBase::Trafo &tr)
+    const RasterBase::Trafo &tr,
+    RasterBackend            backend)
 {
     std::unique_ptr<RasterBase> rst;
     
-    if (gamma > 0)
+    if (backend == RasterBackend::Scanline)
+        rst = std::make_unique<ScanlineRaster>(res, pxdim, tr, std::max(gamma, 0.));
+    else if (gamma > 0)
         rst = std::make_unique<RasterGrayscaleAAGammaPower>(res, pxdim, tr, gamma);
     else if (std::abs(gamma - 1.) < 1e-6)
         rst = std::make_unique<RasterGrayscaleAA>(res, pxdim, tr, agg::gamma_none());
@@ -111,12 +111,19 @@ struct PPMRasterEncoder {
 
 std::ostream& operator<<(std::ostream &stream, const EncodedRaster &bytes);
 
+// Implementation of the rasterizer behind create_raster_grayscale_aa().
+enum class RasterBackend {
+    AGG,     // Anti-Grain Geometry, one polygon at a time, see AGGRaster.hpp
+    Scanline // Whole layer at once, see ScanlineRaster.hpp
+};
+
 // If gamma is zero, thresholding will be performed which disables AA.
 std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     const Resolution        &res,
     const PixelDim          &pxdim,
-    double                   gamma = 1.0,
-    const RasterBase::Trafo &tr    = {});
+    double                   gamma   = 1.0,
+    const RasterBase::Trafo &tr      = {},
+    RasterBackend            backend = RasterBackend::AGG);
 
 }} // namespace Slic3r::sla
 
@@ -0,0 +1,295 @@
+#include "ScanlineRaster.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// SSE2 is part of the x86-64 baseline, no runtime CPU dispatch is needed.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SLIC3R_SCANLINE_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Slic3r { namespace sla {
+
+// Number of cells of the coverage accumulation buffer. The layer is filled
+// in horizontal strips of as many pixel rows as fit into the buffer.
+static constexpr const size_t StripCells = size_t(1) << 18;
+
+// Tolerance of the cover (0 to 256) of a pixel, see render().
+static constexpr const float CoverEps = 1.f / 64.f;
+
+// Vertices are snapped to the subpixel grid of AGG, see agg::ras_conv_int.
+static double snap(double v)
+{
+    return double(int64_t(v < 0. ? v * 256. - .5 : v * 256. + .5)) / 256.;
+}
+
+// agg::blender_gray::blend_pix() of a white pixel.
+static uint8_t blend_white(uint8_t p, uint8_t alpha)
+{
+    int t = (255 - int(p)) * int(alpha) + 128;
+    return uint8_t(p + (((t >> 8) + t) >> 8));
+}
+
+ScanlineRaster::ScanlineRaster(const Resolution &res,
+                               const PixelDim   &pd,
+                               const Trafo      &trafo,
+                               double            gamma)
+    : m_resolution(res)
+    , m_pxdim(pd)
+    , m_trafo(trafo)
+    , m_scale_x(SCALING_FACTOR)
+    , m_scale_y(SCALING_FACTOR)
+    , m_strip_rows(std::clamp(int(StripCells / (res.width_px + 2)), 1, std::max(int(res.height_px), 1)))
+    , m_strips((res.height_px + m_strip_rows - 1) / m_strip_rows)
+    , m_buf(res.pixels(), 0)
+{
+    // Visual Studio compiler gives warnings about possible division by zero.
+    assert(pd.w_mm != 0 && pd.h_mm != 0);
+    if (pd.w_mm != 0 && pd.h_mm != 0) {
+        m_scale_x /= pd.w_mm;
+        m_scale_y /= pd.h_mm;
+    }
+
+    // The table of agg::rasterizer_scanline_aa::gamma() for
+    // agg::gamma_power(gamma) or agg::gamma_threshold(.5).
+    for (size_t c = 0; c < m_gamma.size(); ++c) {
+        double x = double(c) / 255.;
+        double g = gamma > 0 ? std::pow(x, gamma) : (x < .5 ? 0. : 1.);
+        m_gamma[c] = uint8_t(unsigned(g * 255. + .5));
+    }
+}
+
+void ScanlineRaster::add_edge(const Vec2d &a, const Vec2d &b)
+{
+    if (a.y() == b.y())
+        return;
+
+    // Split the edge at the left and right border of the raster. The parts
+    // outside are moved onto the border, where they still contribute their
+    // full coverage to the pixels on the right of them.
+    const double W = double(m_resolution.width_px);
+    for (double xb : { 0., W })
+        if ((a.x() < xb && xb < b.x()) || (b.x() < xb && xb < a.x())) {
+            Vec2d c(xb, a.y() + (xb - a.x()) * (b.y() - a.y()) / (b.x() - a.x()));
+            add_edge(a, c);
+            add_edge(c, b);
+            return;
+        }
+
+    const bool   up = a.y() < b.y();
+    const Vec2d &lo = up ? a : b;
+    const Vec2d &hi = up ? b : a;
+    if (hi.y() <= 0. || lo.y() >= double(m_resolution.height_px))
+        return;
+
+    m_strips[size_t(std::max(lo.y(), 0.)) / size_t(m_strip_rows)].push_back(
+        { float(std::clamp(lo.x(), 0., W)), float(lo.y()), float(std::clamp(hi.x(), 0., W)), float(hi.y()), up ? 1.f : -1.f });
+}
+
+void ScanlineRaster::add_contour(const Points &pts)
+{
+    if (pts.size() < 3)
+        return;
+
+    // Same transformation as AGGRaster::to_path().
+    auto to_px = [this](const Point &p) {
+        double x = p.x() * m_scale_x;
+        double y = p.y() * m_scale_y;
+        if (m_trafo.flipXY)
+            std::swap(x, y);
+        x += m_trafo.center_x * m_scale_x;
+        y += m_trafo.center_y * m_scale_y;
+        if (m_trafo.mirror_x)
+            x = double(m_resolution.width_px) - x;
+        if (m_trafo.mirror_y)
+            y = double(m_resolution.height_px) - y;
+        return Vec2d(snap(x), snap(y));
+    };
+
+    Vec2d a = to_px(pts.back());
+    for (const Point &pt : pts) {
+        Vec2d b = to_px(pt);
+        add_edge(a, b);
+        a = b;
+    }
+}
+
+void ScanlineRaster::draw(const ExPolygon &poly)
+{
+    add_contour(poly.contour.points);
+    for (const Polygon &h : poly.holes)
+        add_contour(h.points);
+}
+
+void ScanlineRaster::render() const
+{
+    if (std::all_of(m_strips.begin(), m_strips.end(), [](const std::vector<Edge> &s) { return s.empty(); }))
+        return;
+
+    const int    W      = int(m_resolution.width_px);
+    const int    H      = int(m_resolution.height_px);
+    const size_t stride = size_t(W) + 2;
+
+    // The signed area of the edges in the cells of a strip. The coverage of
+    // a pixel is the sum of the cells of its row up to the pixel, the same
+    // way as agg::rasterizer_cells_aa accumulates the cover and area of its
+    // cells. The range of the touched cells is kept for each row.
+    std::vector<float>               acc(stride * size_t(m_strip_rows), 0.f);
+    std::vector<std::pair<int, int>> dirty(size_t(m_strip_rows), { W + 2, 0 });
+
+    auto add_area = [&](const Edge &e, int top, int bottom) {
+        const double ya = std::max(double(e.y0), double(top));
+        const double yb = std::min(double(e.y1), double(bottom));
+        if (ya >= yb)
+            return;
+        const double dxdy = (double(e.x1) - e.x0) / (double(e.y1) - e.y0);
+        double       x    = std::clamp(e.x0 + (ya - e.y0) * dxdy, 0., double(W));
+        for (int y = int(ya); y < yb; ++ y) {
+            const double dy      = std::min(double(y + 1), yb) - std::max(double(y), ya);
+            const double xnext   = std::clamp(x + dxdy * dy, 0., double(W));
+            const double d       = dy * e.dir;
+            const double x0      = std::min(x, xnext);
+            const double x1      = std::max(x, xnext);
+            const double x0floor = std::floor(x0);
+            const double x1ceil  = std::ceil(x1);
+            const int    x0i     = int(x0floor);
+            const int    x1i     = int(x1ceil);
+            float       *cells   = acc.data() + size_t(y - top) * stride;
+            if (x1i <= x0i + 1) {
+                // The part of the edge in this row is inside a single pixel.
+                const double xmf = 0.5 * (x + xnext) - x0floor;
+                cells[x0i]     += float(d - d * xmf);
+                cells[x0i + 1] += float(d * xmf);
+            } else {
+                // Triangle in the first pixel, trapezoids in the middle
+                // ones and the rest in the last pixel.
+                const double s   = 1. / (x1 - x0);
+                const double x0f = x0 - x0floor;
+                const double a0  = 0.5 * s * (1. - x0f) * (1. - x0f);
+                const double x1f = x1 - x1ceil + 1.;
+                const double am  = 0.5 * s * x1f * x1f;
+                cells[x0i] += float(d * a0);
+                if (x1i == x0i + 2)
+                    cells[x0i + 1] += float(d * (1. - a0 - am));
+                else {
+                    const double a1 = s * (1.5 - x0f);
+                    cells[x0i + 1] += float(d * (a1 - a0));
+                    for (int xi = x0i + 2; xi < x1i - 1; ++ xi)
+                        cells[xi] += float(d * s);
+                    const double a2 = a1 + (x1i - x0i - 3) * s;
+                    cells[x1i - 1] += float(d * (1. - a2 - am));
+                }
+                cells[x1i] += float(d * am);
+            }
+            auto &[begin, end] = dirty[size_t(y - top)];
+            begin = std::min(begin, x0i);
+            end   = std::max(end, std::max(x0i + 2, x1i + 1));
+            x = xnext;
+        }
+    };
+
+    // Same as agg::rasterizer_scanline_aa::calculate_alpha() with the
+    // non-zero fill rule: cover is floor(256 * area), area being signed.
+    // AGG computes the area exactly in fixed point, here the rounding errors
+    // of the floating point sums are not to flip the cover of the empty and
+    // the fully covered pixels.
+    auto put = [this](uint8_t *dst, int cover) {
+        cover = std::min(std::abs(cover), 255);
+        if (uint8_t alpha = m_gamma[size_t(cover)]; alpha > 0)
+            *dst = blend_white(*dst, alpha);
+    };
+
+    auto resolve_row = [&](float *cells, int begin, int end, uint8_t *dst) {
+        const int pxend = std::min(end, W);
+        int       x     = begin;
+        float     cov   = 0.f;
+#ifdef SLIC3R_SCANLINE_RASTER_SSE2
+        // Prefix sum of four cells at a time.
+        const __m128  lim    = _mm_set1_ps(256.f);
+        const __m128  eps    = _mm_set1_ps(CoverEps);
+        const __m128i fullp  = _mm_set1_epi32(256);
+        const __m128i fulln  = _mm_set1_epi32(-256);
+        const bool    full   = m_gamma.back() == 255;
+        __m128        offset = _mm_setzero_ps();
+        alignas(16) int32_t covers[4];
+        for (; x + 4 <= pxend; x += 4) {
+            __m128 v = _mm_loadu_ps(cells + x);
+            v        = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)));
+            v        = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+            v        = _mm_add_ps(v, offset);
+            offset   = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+            __m128  c = _mm_max_ps(_mm_min_ps(_mm_add_ps(_mm_mul_ps(v, lim), eps), lim), _mm_sub_ps(_mm_setzero_ps(), lim));
+            // floor(), the mask of the truncated lanes above c is -1.
+            __m128i t = _mm_cvttps_epi32(c);
+            t         = _mm_add_epi32(t, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(t), c)));
+            // Runs of empty and of fully covered pixels are common.
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(t, _mm_setzero_si128())) == 0xFFFF)
+                continue;
+            if (full && _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi32(t, fullp), _mm_cmpeq_epi32(t, fulln))) == 0xFFFF) {
+                std::fill(dst + x, dst + x + 4, uint8_t(255));
+                continue;
+            }
+            _mm_store_si128(reinterpret_cast<__m128i *>(covers), t);
+            for (int i = 0; i < 4; ++ i)
+                put(dst + x + i, covers[i]);
+        }
+        cov = _mm_cvtss_f32(offset);
+#endif
+        for (; x < pxend; ++ x) {
+            cov += cells[x];
+            put(dst + x, int(std::floor(std::clamp(cov * 256.f + CoverEps, -256.f, 256.f))));
+        }
+        std::fill(cells + begin, cells + end, 0.f);
+    };
+
+    // Edges of the previous strips reaching into the current one.
+    std::vector<Edge> active;
+    for (size_t strip = 0; strip < m_strips.size(); ++ strip) {
+        std::vector<Edge> &edges = m_strips[strip];
+        if (edges.empty() && active.empty())
+            continue;
+
+        const int top    = int(strip) * m_strip_rows;
+        const int bottom = std::min(H, top + m_strip_rows);
+        for (const Edge &e : active)
+            add_area(e, top, bottom);
+        for (const Edge &e : edges)
+            add_area(e, top, bottom);
+
+        for (int row = top; row < bottom; ++ row) {
+            auto &[begin, end] = dirty[size_t(row - top)];
+            if (begin < end) {
+                resolve_row(acc.data() + size_t(row - top) * stride, begin, end, m_buf.data() + size_t(row) * size_t(W));
+                begin = W + 2;
+                end   = 0;
+            }
+        }
+
+        active.erase(std::remove_if(active.begin(), active.end(), [bottom](const Edge &e) { return e.y1 <= bottom; }), active.end());
+        std::copy_if(edges.begin(), edges.end(), std::back_inserter(active), [bottom](const Edge &e) { return e.y1 > bottom; });
+        edges.clear();
+        edges.shrink_to_fit();
+    }
+}
+
+EncodedRaster ScanlineRaster::encode(RasterEncoder encoder) const
+{
+    render();
+    return encoder(m_buf.data(), m_resolution.width_px, m_resolution.height_px, 1);
+}
+
+uint8_t ScanlineRaster::read_pixel(size_t col, size_t row) const
+{
+    render();
+    return m_buf[row * m_resolution.width_px + col];
+}
+
+void ScanlineRaster::clear()
+{
+    for (std::vector<Edge> &edges : m_strips)
+        edges.clear();
+    std::fill(m_buf.begin(), m_buf.end(), 0);
+}
+
+}} // namespace Slic3r::sla
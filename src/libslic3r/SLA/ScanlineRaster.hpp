@@ -0,0 +1,71 @@
+#ifndef SCANLINERASTER_HPP
+#define SCANLINERASTER_HPP
+
+#include <array>
+#include <vector>
+
+#include <libslic3r/SLA/RasterBase.hpp>
+#include "libslic3r/ExPolygon.hpp"
+
+namespace Slic3r { namespace sla {
+
+// Grayscale raster filling all the polygons of a layer at once with a
+// scanline algorithm, using the non-zero winding rule. The drawn polygons are
+// only collected into an edge table, they are filled when the raster is read
+// or encoded. The coverage of each pixel is the exact area of the polygons
+// inside the pixel, with the vertices snapped to 1/256 of a pixel as AGG
+// does. Coverage is mapped to the pixel values through the same gamma table
+// and blended the same way as by the AGG raster (see AGGRaster.hpp), so both
+// produce the same image up to rounding for non overlapping polygons.
+class ScanlineRaster : public RasterBase {
+public:
+    // If gamma is zero, thresholding will be performed which disables AA.
+    ScanlineRaster(const Resolution &res,
+                   const PixelDim   &pd,
+                   const Trafo      &trafo,
+                   double            gamma = 1.);
+
+    void  draw(const ExPolygon &poly) override;
+    Trafo trafo() const override { return m_trafo; }
+
+    EncodedRaster encode(RasterEncoder encoder) const override;
+
+    Resolution resolution() const { return m_resolution; }
+    PixelDim   pixel_dimensions() const { return m_pxdim; }
+
+    uint8_t read_pixel(size_t col, size_t row) const;
+
+    void clear();
+
+private:
+    // Edge of a polygon in pixel coordinates, y0 < y1, 0 <= x <= width.
+    // The vertices are on the 1/256 subpixel grid, exact in floats.
+    struct Edge {
+        float x0, y0, x1, y1;
+        // +1 for an edge going up, -1 for an edge going down.
+        float dir;
+    };
+
+    void add_contour(const Points &pts);
+    void add_edge(const Vec2d &a, const Vec2d &b);
+    // Fill the collected edges into the pixel buffer.
+    void render() const;
+
+    Resolution m_resolution;
+    PixelDim   m_pxdim;
+    Trafo      m_trafo;
+    // Scaled coordinates to pixels.
+    double     m_scale_x, m_scale_y;
+    // Coverage (0 to 255) to pixel value.
+    std::array<uint8_t, 256> m_gamma;
+
+    // Pixel rows of a strip filled at once and the edges starting in each
+    // strip, see render().
+    int                                    m_strip_rows;
+    mutable std::vector<std::vector<Edge>> m_strips;
+    mutable std::vector<uint8_t>           m_buf;
+};
+
+}} // namespace Slic3r::sla
+
+#endif // SCANLINERASTER_HPP
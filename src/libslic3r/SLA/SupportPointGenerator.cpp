@@ -93,26 +93,38 @@ void SupportPointGenerator::project_onto_mesh(std::vector<sla::SupportPoint>& po
     // Use a reasonable granularity to account for the worker thread synchronization cost.
     static constexpr size_t gransize = 64;
 
-    execution::for_each(ex_tbb, size_t(0), points.size(), [this, &points](size_t idx)
+    // The vertical rays of a chunk of points are cast as a batch, traversing the AABB tree in packets.
+    execution::for_each(ex_tbb, size_t(0), (points.size() + gransize - 1) / gransize, [this, &points](size_t chunk_idx)
     {
-        if ((idx % 16) == 0)
-            // Don't call the following function too often as it flushes CPU write caches due to synchronization primitves.
-            m_throw_on_cancel();
+        // Called once per chunk of gransize points, as it flushes CPU write caches due to synchronization primitves.
+        m_throw_on_cancel();
+
+        size_t             idx_begin = chunk_idx * gransize;
+        size_t             idx_end   = std::min(idx_begin + gransize, points.size());
+        std::vector<Vec3d> sources;
+        sources.reserve(idx_end - idx_begin);
+        for (size_t idx = idx_begin; idx < idx_end; ++ idx)
+            sources.emplace_back(points[idx].pos.cast<double>());
+
+        // Project the points upward and downward and choose the closer intersection with the mesh.
+        std::vector<AABBMesh::hit_result> hits_up   = m_emesh.query_ray_hit(sources, std::vector<Vec3d>(sources.size(), Vec3d(0., 0., 1.)));
+        std::vector<AABBMesh::hit_result> hits_down = m_emesh.query_ray_hit(sources, std::vector<Vec3d>(sources.size(), Vec3d(0., 0., -1.)));
 
-        Vec3f& p = points[idx].pos;
-        // Project the point upward and downward and choose the closer intersection with the mesh.
-        AABBMesh::hit_result hit_up   = m_emesh.query_ray_hit(p.cast<double>(), Vec3d(0., 0., 1.));
-        AABBMesh::hit_result hit_down = m_emesh.query_ray_hit(p.cast<double>(), Vec3d(0., 0., -1.));
+        for (size_t i = 0; i < sources.size(); ++ i) {
+            AABBMesh::hit_result &hit_up   = hits_up[i];
+            AABBMesh::hit_result &hit_down = hits_down[i];
 
-        bool up   = hit_up.is_hit();
-        bool down = hit_down.is_hit();
+            bool up   = hit_up.is_hit();
+            bool down = hit_down.is_hit();
 
-        if (!up && !down)
-            return;
+            if (!up && !down)
+                continue;
 
-        AABBMesh::hit_result& hit = (!down || (hit_up.distance() < hit_down.distance())) ? hit_up : hit_down;
-        p = p + (hit.distance() * hit.direction()).cast<float>();
-    }, gransize);
+            AABBMesh::hit_result& hit = (!down || (hit_up.distance() < hit_down.distance())) ? hit_up : hit_down;
+            Vec3f& p = points[idx_begin + i].pos;
+            p = p + (hit.distance() * hit.direction()).cast<float>();
+        }
+    });
 }
 
 static std::vector<SupportPointGenerator::MyLayer> make_layers(
@@ -1343,9 +1343,10 @@ void SLAPrint::Steps::rasterize()
     // last minute escape
     if(canceled()) return;
 
-    // Print all the layers in parallel
+    // Print all the layers in parallel. The archiver spools the encoded
+    // layers, only a few of them are held in memory at a time.
     m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn,
-                                    [this]() { return canceled(); }, ex_tbb);
+                                    [this]() { return canceled(); });
 }
 
 std::string SLAPrint::Steps::label(SLAPrintObjectStep step)
@@ -0,0 +1,125 @@
+#include "SlicingService.hpp"
+#include "ModelArrange.hpp"
+#include "Utils.hpp"
+#include "GCode/PostProcessor.hpp"
+#include "Utils/JsonUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace Slic3r {
+
+std::string process_and_export(PrinterTechnology printer_technology, Print &fff_print, SLAPrint &sla_print, std::string outfile)
+{
+    std::string outfile_final;
+    if (printer_technology == ptFFF) {
+        fff_print.process();
+        // The outfile is processed by a PlaceholderParser.
+        outfile = fff_print.export_gcode(outfile, nullptr, nullptr);
+        outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
+    } else {
+        sla_print.process();
+        outfile = sla_print.output_filepath(outfile);
+        // We need to finalize the filename beforehand because the export function sets the filename inside the zip metadata
+        outfile_final = sla_print.print_statistics().finalize_output_path(outfile);
+        sla_print.export_print(outfile_final);
+    }
+    if (outfile != outfile_final) {
+        if (Slic3r::rename_file(outfile, outfile_final))
+            throw Slic3r::RuntimeError("Renaming file " + outfile + " to " + outfile_final + " failed");
+        outfile = outfile_final;
+    }
+    // Run the post-processing scripts if defined.
+    run_post_process_scripts(outfile, fff_print.full_print_config());
+    return outfile;
+}
+
+SlicingService::ServedModel& SlicingService::served_model(const std::string &path)
+{
+    if (! boost::filesystem::exists(path))
+        throw Slic3r::RuntimeError("No such file: " + path);
+    const std::time_t last_write_time = boost::filesystem::last_write_time(path);
+    auto it = m_models.find(path);
+    if (it == m_models.end() || it->second->last_write_time != last_write_time) {
+        // Load the model for the first time or reload it after it was changed.
+        // The model is only stored once it was loaded successfully.
+        auto model = std::make_unique<ServedModel>();
+        DynamicPrintConfig        config;
+        ConfigSubstitutionContext config_substitutions(ForwardCompatibilitySubstitutionRule::EnableSilent);
+        model->model = Model::read_from_file(path, &config, &config_substitutions, Model::LoadAttribute::AddDefaultInstances);
+        // The configuration of the service is fixed when it is started, the configuration stored in a project file would be ignored.
+        if (! config.empty())
+            throw Slic3r::RuntimeError(path + ": Configuration stored in a project file is not supported by the slicing service, load it with --load when starting the service");
+        if (model->model.objects.empty())
+            throw Slic3r::RuntimeError("Error: file is empty: " + path);
+        model->last_write_time = last_write_time;
+        if (m_ensure_on_bed)
+            for (ModelObject *o : model->model.objects)
+                o->ensure_on_bed();
+        // Arrange once, a stable position of the objects keeps the slicing results valid.
+        // The geometry of a model loaded from 3mf is used as is, the same way the command line does.
+        if (m_arrange && ! boost::algorithm::iends_with(path, ".3mf") && ! boost::algorithm::iends_with(path, ".zip"))
+            arrange_objects(model->model, m_bed, m_arrange_cfg);
+        if (m_printer_technology == ptFFF)
+            for (ModelObject *mo : model->model.objects)
+                model->fff_print.auto_assign_extruders(mo);
+        it = m_models.insert_or_assign(path, std::move(model)).first;
+    }
+    ServedModel &served = *it->second;
+    served.last_used = ++ m_requests;
+    if (m_models.size() > MaxServedModels)
+        m_models.erase(std::min_element(m_models.begin(), m_models.end(),
+            [](const auto &l, const auto &r) { return l.second->last_used < r.second->last_used; }));
+    return served;
+}
+
+std::string SlicingService::handle(const std::string &request)
+{
+    namespace pt = boost::property_tree;
+    auto      t0 = std::chrono::steady_clock::now();
+    pt::ptree response;
+    try {
+        pt::ptree request_tree;
+        std::istringstream is(request);
+        pt::read_json(is, request_tree);
+        if (request_tree.get<std::string>("command", "slice") == "shutdown") {
+            m_shutdown = true;
+        } else {
+            ServedModel &served = this->served_model(request_tree.get<std::string>("model"));
+            // Configuration values of the request override the configuration loaded from the command line.
+            DynamicPrintConfig config = m_print_config;
+            if (boost::optional<pt::ptree&> overrides = request_tree.get_child_optional("config"))
+                for (const auto &[opt_key, value] : *overrides)
+                    config.set_deserialize_strict(opt_key, value.data());
+            if (m_printer_technology == ptFFF)
+                config.normalize_fdm();
+            if (std::string err = config.validate(); ! err.empty())
+                throw Slic3r::RuntimeError(err);
+            PrintBase *print = m_printer_technology == ptFFF ? static_cast<PrintBase*>(&served.fff_print) : static_cast<PrintBase*>(&served.sla_print);
+            // Only the steps invalidated by the changed configuration values are recalculated.
+            print->apply(served.model, config);
+            if (std::string err = print->validate(); ! err.empty())
+                throw Slic3r::RuntimeError(err);
+            if (print->empty())
+                throw Slic3r::RuntimeError("Nothing to print. Either the print is empty or no object is fully inside the print volume.");
+            response.put("output", process_and_export(m_printer_technology, served.fff_print, served.sla_print, request_tree.get<std::string>("output", std::string())));
+        }
+        response.put("success", true);
+    } catch (const std::exception &ex) {
+        response.put("success", false);
+        response.put("error", ex.what());
+    }
+    response.put("time", std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    std::string out = write_json_with_post_process(response, false);
+    boost::trim_right(out);
+    return out;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,66 @@
+#ifndef slic3r_SlicingService_hpp_
+#define slic3r_SlicingService_hpp_
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Model.hpp"
+#include "Print.hpp"
+#include "PrintConfig.hpp"
+#include "SLAPrint.hpp"
+#include "Arrange/Core/Beds.hpp"
+#include "Arrange/ArrangeSettingsView.hpp"
+
+namespace Slic3r {
+
+// Slice the print and export the result, run the post-processing scripts.
+// For FFF, outfile is processed by the PlaceholderParser. Returns the path of the exported file, throws on error.
+std::string process_and_export(PrinterTechnology printer_technology, Print &fff_print, SLAPrint &sla_print, std::string outfile);
+
+// Slicing service answering the requests received by the --serve command line action.
+// The models are kept loaded together with the prints sliced from them, thus Print::apply() invalidates
+// just the steps affected by the configuration values changed by a request and the other steps are reused.
+class SlicingService
+{
+public:
+    SlicingService(const DynamicPrintConfig &print_config, PrinterTechnology printer_technology,
+                   bool arrange, bool ensure_on_bed, const arr2::ArrangeBed &bed, const arr2::ArrangeSettings &arrange_cfg) :
+        m_print_config(print_config), m_printer_technology(printer_technology),
+        m_arrange(arrange), m_ensure_on_bed(ensure_on_bed), m_bed(bed), m_arrange_cfg(arrange_cfg) {}
+
+    // Process a single request, return a single line JSON response.
+    std::string handle(const std::string &request);
+    bool        shutdown_requested() const { return m_shutdown; }
+    // Number of the models kept loaded.
+    size_t      num_served_models() const { return m_models.size(); }
+
+private:
+    struct ServedModel
+    {
+        Model       model;
+        std::time_t last_write_time { 0 };
+        size_t      last_used       { 0 };
+        Print       fff_print;
+        SLAPrint    sla_print;
+    };
+    // Maximum number of models kept loaded, the least recently used one is released first.
+    static constexpr const size_t MaxServedModels = 32;
+
+    ServedModel& served_model(const std::string &path);
+
+    const DynamicPrintConfig       &m_print_config;
+    PrinterTechnology               m_printer_technology;
+    bool                            m_arrange;
+    bool                            m_ensure_on_bed;
+    const arr2::ArrangeBed         &m_bed;
+    const arr2::ArrangeSettings    &m_arrange_cfg;
+    std::map<std::string, std::unique_ptr<ServedModel>> m_models;
+    size_t                          m_requests { 0 };
+    bool                            m_shutdown { false };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_SlicingService_hpp_
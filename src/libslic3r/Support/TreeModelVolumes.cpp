@@ -853,12 +853,35 @@ coord_t TreeModelVolumes::ceilRadius(const coord_t radius) const
     return out;
 }
 
+void TreeModelVolumes::RadiusLayerPolygonCache::LayerData::emplace(coord_t radius, Polygons &&polygons)
+{
+    size_t i = this->lower_bound(radius);
+    if (i == radii.size() || radii[i] != radius) {
+        radii.insert(radii.begin() + i, radius);
+        this->polygons.insert(this->polygons.begin() + i, std::make_unique<Polygons>(std::move(polygons)));
+    }
+}
+
+void TreeModelVolumes::RadiusLayerPolygonCache::reserve_layers(size_t num_layers)
+{
+    {
+        std::shared_lock<std::shared_mutex> guard(m_layer_locks.front().mutex);
+        if (num_layers <= m_data.size())
+            return;
+    }
+    // Lock all the layers in the same order to not deadlock with another thread growing the vector of layers.
+    std::array<std::unique_lock<std::shared_mutex>, NumLayerLocks> guards;
+    for (size_t i = 0; i < NumLayerLocks; ++ i)
+        guards[i] = std::unique_lock<std::shared_mutex>(m_layer_locks[i].mutex);
+    this->allocate_layers(num_layers);
+}
+
 void TreeModelVolumes::RadiusLayerPolygonCache::allocate_layers(size_t num_layers)
 {
     if (num_layers > m_data.size()) {
         if (num_layers > m_data.capacity())
             reserve_power_of_2(m_data, num_layers);
-        m_data.resize(num_layers, {});
+        m_data.resize(num_layers);
     }
 }
 
@@ -868,11 +891,41 @@ std::vector<std::pair<TreeModelVolumes::RadiusLayerPair, std::reference_wrapper<
     std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> out;
     for (auto &layer : m_data) {
         auto layer_idx = LayerIndex(&layer - m_data.data());
-        for (auto &radius_polygons : layer)
-            out.emplace_back(std::make_pair(radius_polygons.first, layer_idx), radius_polygons.second);
+        for (size_t i = 0; i < layer.radii.size(); ++ i)
+            out.emplace_back(std::make_pair(layer.radii[i], layer_idx), *layer.polygons[i]);
     }
     assert(std::is_sorted(out.begin(), out.end(), [](auto &l, auto &r){ return l.first.second < r.first.second || (l.first.second == r.first.second) && l.first.first < r.first.first; }));
     return out;
 }
 
+TreeModelVolumes::RadiusLayerPolygonCache::Statistics TreeModelVolumes::RadiusLayerPolygonCache::statistics() const
+{
+    Statistics out;
+    for (const LayerLock &lock : m_layer_locks) {
+        out.hits   += lock.hits.load(std::memory_order_relaxed);
+        out.misses += lock.misses.load(std::memory_order_relaxed);
+        out.waits  += lock.waits.load(std::memory_order_relaxed);
+    }
+    return out;
+}
+
+void TreeModelVolumes::log_cache_statistics() const
+{
+    auto log = [](const RadiusLayerPolygonCache &cache, std::string_view name) {
+        RadiusLayerPolygonCache::Statistics stats = cache.statistics();
+        BOOST_LOG_TRIVIAL(debug) << "Tree support " << name << ": " << stats.hits << " hits, " << stats.misses << " misses, " << stats.waits << " lock waits";
+    };
+    log(m_collision_cache,                    "collision_cache");
+    log(m_collision_cache_holefree,           "collision_cache_holefree");
+    log(m_avoidance_cache,                    "avoidance_cache");
+    log(m_avoidance_cache_slow,               "avoidance_cache_slow");
+    log(m_avoidance_cache_to_model,           "avoidance_cache_to_model");
+    log(m_avoidance_cache_to_model_slow,      "avoidance_cache_to_model_slow");
+    log(m_placeable_areas_cache,              "placable_areas_cache");
+    log(m_avoidance_cache_holefree,           "avoidance_cache_holefree");
+    log(m_avoidance_cache_holefree_to_model,  "avoidance_cache_holefree_to_model");
+    log(m_wall_restrictions_cache,            "wall_restrictions_cache");
+    log(m_wall_restrictions_cache_min,        "wall_restrictions_cache_min");
+}
+
 } // namespace Slic3r::FFFTreeSupport
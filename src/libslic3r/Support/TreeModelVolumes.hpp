@@ -13,7 +13,12 @@
 #ifndef slic3r_TreeModelVolumes_hpp
 #define slic3r_TreeModelVolumes_hpp
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include <boost/functional/hash.hpp>
@@ -90,6 +95,9 @@ public:
      */
     void precalculate(const PrintObject& print_object, const coord_t max_layer, std::function<void()> throw_on_cancel);
 
+    // Log the hits, misses and lock waits of the caches to see how effective the caches are.
+    void log_cache_statistics() const;
+
     /*!
      * \brief Provides the areas that have to be avoided by the tree's branches to prevent collision with the model on this layer.
      *
@@ -200,11 +208,35 @@ private:
      */
     using RadiusLayerPair             = std::pair<coord_t, LayerIndex>;
     class RadiusLayerPolygonCache {
-        // Map from radius to Polygons. Cache of one layer collision regions.
-        using LayerData = std::map<coord_t, Polygons>;
-        // Vector of layers, at each layer map of radius to Polygons.
-        // Reference to Polygons returned shall be stable to insertion.
+        // Cache of one layer collision regions: Radii sorted in ascending order, Polygons of the matching radius.
+        // Polygons are allocated separately, reference to Polygons returned shall be stable to insertion.
+        struct LayerData {
+            std::vector<coord_t>                   radii;
+            std::vector<std::unique_ptr<Polygons>> polygons;
+
+            bool   empty() const { return radii.empty(); }
+            // Index of the first radius not lower than the radius queried.
+            size_t lower_bound(coord_t radius) const { return std::lower_bound(radii.begin(), radii.end(), radius) - radii.begin(); }
+            bool   contains(coord_t radius) const { size_t i = this->lower_bound(radius); return i < radii.size() && radii[i] == radius; }
+            // Does not overwrite Polygons already stored for the same radius.
+            void   emplace(coord_t radius, Polygons &&polygons);
+        };
+        // Vector of layers, at each layer radii and their Polygons.
         using Layers = std::vector<LayerData>;
+
+        // Layers are guarded by a fixed number of read / write locks, layer_idx modulo the number of locks,
+        // thus readers never block each other and writers block just the readers of their few layers.
+        // Growing the vector of layers takes all the locks.
+        struct alignas(64) LayerLock {
+            std::shared_mutex               mutex;
+            // Statistics of the layers guarded by this lock, kept here not to share a cache line between threads.
+            std::atomic<size_t>             hits   { 0 };
+            std::atomic<size_t>             misses { 0 };
+            // Number of times a thread had to wait for the lock.
+            std::atomic<size_t>             waits  { 0 };
+        };
+        static constexpr const size_t NumLayerLocks = 64;
+
     public:
         RadiusLayerPolygonCache() = default;
         RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) : m_data(std::move(rhs.m_data)) {}
@@ -214,28 +246,40 @@ private:
         RadiusLayerPolygonCache& operator=(const RadiusLayerPolygonCache&) = delete;
 
         void insert(std::vector<std::pair<RadiusLayerPair, Polygons>> &&in) {
-            std::lock_guard<std::mutex> guard(m_mutex);
+            LayerIndex max_layer_idx = -1;
             for (auto &d : in)
-                this->get_allocate_layer_data(d.first.second).emplace(d.first.first, std::move(d.second));
+                max_layer_idx = std::max(max_layer_idx, d.first.second);
+            this->reserve_layers(max_layer_idx + 1);
+            for (auto &d : in) {
+                std::unique_lock<std::shared_mutex> guard(this->layer_lock(d.first.second).mutex);
+                m_data[d.first.second].emplace(d.first.first, std::move(d.second));
+            }
         }
         // by layer
         void insert(std::vector<std::pair<coord_t, Polygons>> &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
+            LayerIndex max_layer_idx = -1;
             for (auto &d : in)
-                this->get_allocate_layer_data(d.first).emplace(radius, std::move(d.second));
+                max_layer_idx = std::max(max_layer_idx, LayerIndex(d.first));
+            this->reserve_layers(max_layer_idx + 1);
+            for (auto &d : in) {
+                std::unique_lock<std::shared_mutex> guard(this->layer_lock(d.first).mutex);
+                m_data[d.first].emplace(radius, std::move(d.second));
+            }
         }
         void insert(std::vector<Polygons> &&in, coord_t first_layer_idx, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            allocate_layers(first_layer_idx + in.size());
-            for (auto &d : in)
+            this->reserve_layers(first_layer_idx + in.size());
+            for (auto &d : in) {
+                std::unique_lock<std::shared_mutex> guard(this->layer_lock(first_layer_idx).mutex);
                 m_data[first_layer_idx ++].emplace(radius, std::move(d));
+            }
         }
         void insert(LayerPolygonCache &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
             LayerIndex i = in.begin();
-            allocate_layers(i + LayerIndex(in.size()));
-            for (auto &d : in.polygons_mutable())
+            this->reserve_layers(i + LayerIndex(in.size()));
+            for (auto &d : in.polygons_mutable()) {
+                std::unique_lock<std::shared_mutex> guard(this->layer_lock(i).mutex);
                 m_data[i ++].emplace(radius, std::move(d));
+            }
         }
         /*!
          * \brief Checks a cache for a given RadiusLayerPair and returns it if it is found
@@ -243,33 +287,35 @@ private:
          * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
          */
         std::optional<std::reference_wrapper<const Polygons>> getArea(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-
-            if (key.second >= LayerIndex(m_data.size()))
-                return std::nullopt;
-
-            const LayerData &layer = m_data[key.second];
-            auto it = layer.find(key.first);
-            if (it == layer.end())
-                return std::nullopt;
-
-            return std::optional<std::reference_wrapper<const Polygons>>{it->second};
+            LayerLock &lock = this->layer_lock(key.second);
+            std::shared_lock<std::shared_mutex> guard = lock_shared(lock);
+
+            if (key.second < LayerIndex(m_data.size())) {
+                const LayerData &layer = m_data[key.second];
+                if (size_t i = layer.lower_bound(key.first); i < layer.radii.size() && layer.radii[i] == key.first) {
+                    lock.hits.fetch_add(1, std::memory_order_relaxed);
+                    return std::optional<std::reference_wrapper<const Polygons>>{ *layer.polygons[i] };
+                }
+            }
+            lock.misses.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
         }
         // Get a collision area at a given layer for a radius that is a lower or equial to the key radius.
         std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> get_lower_bound_area(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            if (key.second >= LayerIndex(m_data.size()))
-                return {};
-            const auto &layer = m_data[key.second];
-            if (layer.empty())
-                return {};
-            auto it = layer.lower_bound(key.first);
-            if (it == layer.end() || it->first != key.first) {
-                if (it == layer.begin())
-                    return {};
-                -- it;
+            LayerLock &lock = this->layer_lock(key.second);
+            std::shared_lock<std::shared_mutex> guard = lock_shared(lock);
+
+            if (key.second < LayerIndex(m_data.size())) {
+                const LayerData &layer = m_data[key.second];
+                // Index of the last radius lower or equal to the key radius.
+                size_t i = std::upper_bound(layer.radii.begin(), layer.radii.end(), key.first) - layer.radii.begin();
+                if (i > 0) {
+                    lock.hits.fetch_add(1, std::memory_order_relaxed);
+                    return std::make_pair(layer.radii[i - 1], std::reference_wrapper<const Polygons>(*layer.polygons[i - 1]));
+                }
             }
-            return std::make_pair(it->first, std::reference_wrapper<const Polygons>(it->second));
+            lock.misses.fetch_add(1, std::memory_order_relaxed);
+            return {};
         }
         /*!
          * \brief Get the highest already calculated layer in the cache.
@@ -279,11 +325,17 @@ private:
          * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
          */
         LayerIndex getMaxCalculatedLayer(coord_t radius) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            auto layer_idx = LayerIndex(m_data.size()) - 1;
-            for (; layer_idx > 0; -- layer_idx)
-                if (const auto &layer = m_data[layer_idx]; layer.find(radius) != layer.end())
+            // Layers are never removed while the cache is being filled in, thus the number of layers may only grow.
+            LayerIndex layer_idx;
+            {
+                std::shared_lock<std::shared_mutex> guard = lock_shared(m_layer_locks.front());
+                layer_idx = LayerIndex(m_data.size()) - 1;
+            }
+            for (; layer_idx > 0; -- layer_idx) {
+                std::shared_lock<std::shared_mutex> guard = lock_shared(this->layer_lock(layer_idx));
+                if (m_data[layer_idx].contains(radius))
                     break;
+            }
             // The placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
             return layer_idx == 0 ? -1 : layer_idx;
         }
@@ -291,25 +343,40 @@ private:
         // For debugging purposes, sorted by layer index, then by radius.
         [[nodiscard]] std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> sorted() const;
 
+        struct Statistics {
+            size_t hits   { 0 };
+            size_t misses { 0 };
+            size_t waits  { 0 };
+        };
+        // Cache hits, misses and lock waits accumulated since the cache was created.
+        [[nodiscard]] Statistics statistics() const;
+
         void clear() { m_data.clear(); }
         void clear_all_but_radius0() { 
-            for (LayerData &l : m_data) {
-                auto begin = l.begin();
-                auto end = l.end();
-                if (begin != end && ++ begin != end)
-                    l.erase(begin, end);
-            }
+            for (LayerData &l : m_data)
+                if (l.radii.size() > 1) {
+                    l.radii.erase(l.radii.begin() + 1, l.radii.end());
+                    l.polygons.erase(l.polygons.begin() + 1, l.polygons.end());
+                }
         }
 
     private:
-        LayerData&          get_allocate_layer_data(LayerIndex layer_idx) {
-            allocate_layers(layer_idx + 1);
-            return m_data[layer_idx];
+        LayerLock&          layer_lock(LayerIndex layer_idx) const { return m_layer_locks[size_t(layer_idx) % NumLayerLocks]; }
+        // Take a shared lock, count the cases when the lock was held by a writer.
+        static std::shared_lock<std::shared_mutex> lock_shared(LayerLock &lock) {
+            std::shared_lock<std::shared_mutex> guard(lock.mutex, std::try_to_lock);
+            if (! guard.owns_lock()) {
+                lock.waits.fetch_add(1, std::memory_order_relaxed);
+                guard.lock();
+            }
+            return guard;
         }
+        // Allocate layers up to num_layers, taking all the layer locks if the vector of layers has to grow.
+        void                reserve_layers(size_t num_layers);
         void                allocate_layers(size_t num_layers);
 
         Layers              m_data;
-        mutable std::mutex  m_mutex;
+        mutable std::array<LayerLock, NumLayerLocks> m_layer_locks;
     };
 
 
@@ -516,7 +516,7 @@ ObjectPart::ObjectPart(
             continue;
         }
 
-        for (const ExtrusionEntity* entity: collection->flatten()) {
+        for (const ExtrusionEntity* entity: collection->leaves()) {
             Polylines polylines;
             std::vector<float> widths;
 
@@ -1244,7 +1244,7 @@ void estimate_supports_malformations(SupportLayerPtrs &layers, float flow_width,
         l->curled_lines.clear();
         std::vector<ExtrusionLine> current_layer_lines;
 
-        for (const ExtrusionEntity *extrusion : l->support_fills.flatten().entities) {
+        for (const ExtrusionEntity *extrusion : l->support_fills.leaves()) {
             Polyline pl = extrusion->as_polyline();
             Polygon  pol(pl.points);
             pol.make_counter_clockwise();
@@ -1318,7 +1318,7 @@ void estimate_malformations(LayerPtrs &layers, const Params &params)
         AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary{std::move(boundary_lines)};
         std::vector<ExtrusionLine>           current_layer_lines;
         for (const LayerRegion *layer_region : l->regions()) {
-            for (const ExtrusionEntity *extrusion : layer_region->perimeters().flatten().entities) {
+            for (const ExtrusionEntity *extrusion : layer_region->perimeters().leaves()) {
                 if (!extrusion->role().is_external_perimeter())
                     continue;
 
@@ -29,7 +29,9 @@
 #include <libqhullcpp/QhullFacetList.h>
 #include <libqhullcpp/QhullVertexSet.h>
 
+#include <atomic>
 #include <cmath>
+#include <cstring>
 #include <deque>
 #include <queue>
 #include <vector>
@@ -37,11 +39,18 @@
 #include <algorithm>
 #include <type_traits>
 
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/nowide/convert.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
 
+#include <fast_float/fast_float.h>
+
 #include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 
 #include <Eigen/Core>
 #include <Eigen/Dense>
@@ -194,10 +203,262 @@ static void trianglemesh_repair_on_import(stl_file &stl)
     BOOST_LOG_TRIVIAL(debug) << "TriangleMesh::repair() finished";
 }
 
+#if BOOST_ENDIAN_BIG_BYTE
+extern void stl_internal_reverse_quads(char *buf, size_t cnt);
+#endif /* BOOST_ENDIAN_BIG_BYTE */
+
+// Parser of ASCII STL, accepting the same syntax as admesh stl_read().
+namespace stl_ascii {
+    static inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+    static inline const char* skip_space(const char *c, const char *end) { while (c != end && is_space(*c)) ++ c; return c; }
+    static inline const char* skip_line(const char *c, const char *end) { while (c != end && *c != '\n' && *c != '\r') ++ c; return c; }
+    static inline bool starts_with(const char *c, const char *end, const char *prefix)
+    {
+        const size_t len = strlen(prefix);
+        return size_t(end - c) >= len && strncmp(c, prefix, len) == 0;
+    }
+    // Consume a keyword followed by a white space or by the end of the file.
+    static inline bool keyword(const char *&c, const char *end, const char *kw)
+    {
+        c = skip_space(c, end);
+        const size_t len = strlen(kw);
+        if (! starts_with(c, end, kw) || (c + len != end && ! is_space(c[len])))
+            return false;
+        c += len;
+        return true;
+    }
+    static inline bool parse_float(const char *&c, const char *end, float &out)
+    {
+        c = skip_space(c, end);
+        if (c != end && *c == '+')
+            ++ c;
+        auto [pend, ec] = fast_float::from_chars(c, end, out);
+        if (ec != std::errc() && ec != std::errc::result_out_of_range)
+            return false;
+        c = pend;
+        return true;
+    }
+
+    // Returns the end of the facet or nullptr on a syntax error.
+    static const char* parse_facet(const char *c, const char *end, stl_facet &facet)
+    {
+        if (! keyword(c, end, "facet") || ! keyword(c, end, "normal"))
+            return nullptr;
+        // The normal is parsed as three tokens as a workaround for not a numbers in the normal definition.
+        // Normal was mangled? Just reset it and silently ignore it.
+        bool normal_valid = true;
+        for (int i = 0; i < 3; ++ i) {
+            c = skip_space(c, end);
+            const char *token_end = c;
+            while (token_end != end && ! is_space(*token_end))
+                ++ token_end;
+            if (c == token_end)
+                return nullptr;
+            const char *p = *c == '+' ? c + 1 : c;
+            auto ec = fast_float::from_chars(p, token_end, facet.normal(i)).ec;
+            normal_valid &= ec == std::errc() || ec == std::errc::result_out_of_range;
+            c = token_end;
+        }
+        if (! normal_valid)
+            facet.normal = stl_normal::Zero();
+        if (! keyword(c, end, "outer") || ! keyword(c, end, "loop"))
+            return nullptr;
+        for (int i = 0; i < 3; ++ i)
+            if (! keyword(c, end, "vertex") ||
+                ! parse_float(c, end, facet.vertex[i].x()) || ! parse_float(c, end, facet.vertex[i].y()) || ! parse_float(c, end, facet.vertex[i].z()))
+                return nullptr;
+        // Some G-code generators tend to produce text after "endloop" and "endfacet". Just ignore it.
+        if (! keyword(c, end, "endloop"))
+            return nullptr;
+        c = skip_line(c, end);
+        if (! keyword(c, end, "endfacet"))
+            return nullptr;
+        return skip_line(c, end);
+    }
+
+    // Number of lines starting with the "facet" keyword. Each facet parsed by parse_facet() starts a new line,
+    // thus it is the number of facets of a valid file.
+    static size_t count_facets(const char *c, const char *end)
+    {
+        size_t cnt = 0;
+        for (;;) {
+            c = skip_space(c, end);
+            if (c == end)
+                return cnt;
+            if (keyword(c, end, "facet"))
+                ++ cnt;
+            c = skip_line(c, end);
+        }
+    }
+
+    // Parse exactly cnt facets into out.
+    static bool parse_facets(const char *c, const char *end, stl_facet *out, size_t cnt)
+    {
+        for (stl_facet *out_end = out + cnt;;) {
+            c = skip_space(c, end);
+            if (c == end)
+                return out == out_end;
+            // Skip solid/endsolid lines as broken STL file generators may put several of them.
+            if (starts_with(c, end, "solid") || starts_with(c, end, "endsolid")) {
+                c = skip_line(c, end);
+                continue;
+            }
+            if (out == out_end)
+                return false;
+            memset(out->extra, 0, sizeof(out->extra));
+            if (c = parse_facet(c, end, *out); c == nullptr)
+                return false;
+            ++ out;
+        }
+    }
+
+    // Start of the first line at or after c, which starts a facet.
+    static const char* next_facet(const char *c, const char *begin, const char *end)
+    {
+        if (c != begin && c[-1] != '\n' && c[-1] != '\r')
+            c = skip_line(c, end);
+        for (;;) {
+            c = skip_space(c, end);
+            const char *line = c;
+            if (c == end || keyword(c, end, "facet"))
+                return line;
+            c = skip_line(c, end);
+        }
+    }
+} // namespace stl_ascii
+
+// Replacement of admesh stl_open() for reading large files: The file is memory mapped and the facets are parsed in parallel.
+// The facets and the statistics collected while reading are the same as those of stl_open(), the facet count of an ASCII STL
+// is the number of facets parsed instead of an estimate from the number of lines.
+static bool stl_open_mapped(stl_file &stl, const char *input_file)
+{
+    stl.clear();
+
+    boost::iostreams::mapped_file_source file;
+    try {
+#ifdef _WIN32
+        file.open(boost::filesystem::path(boost::nowide::widen(input_file)));
+#else
+        file.open(std::string(input_file));
+#endif
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "stl_open_mapped: Couldn't open " << input_file << " for reading: " << ex.what();
+        return false;
+    }
+    const char  *data      = file.data();
+    const size_t file_size = file.size();
+
+    // Check for binary or ASCII file.
+    if (file_size < HEADER_SIZE + 128) {
+        BOOST_LOG_TRIVIAL(error) << "stl_open_mapped: The input is an empty file: " << input_file;
+        return false;
+    }
+    stl.stats.type = ascii;
+    for (size_t i = HEADER_SIZE; i < HEADER_SIZE + 128; ++ i)
+        if (static_cast<unsigned char>(data[i]) > 127) {
+            stl.stats.type = binary;
+            break;
+        }
+
+    if (stl.stats.type == binary) {
+        if ((file_size - HEADER_SIZE) % SIZEOF_STL_FACET != 0 || file_size < STL_MIN_FILE_SIZE) {
+            BOOST_LOG_TRIVIAL(error) << "stl_open_mapped: The file " << input_file << " has the wrong size.";
+            return false;
+        }
+        const uint32_t num_facets = uint32_t((file_size - HEADER_SIZE) / SIZEOF_STL_FACET);
+        memcpy(stl.stats.header, data, LABEL_SIZE);
+        uint32_t header_num_facets;
+        memcpy(&header_num_facets, data + LABEL_SIZE, sizeof(uint32_t));
+#if BOOST_ENDIAN_BIG_BYTE
+        stl_internal_reverse_quads((char*)&header_num_facets, 4);
+#endif /* BOOST_ENDIAN_BIG_BYTE */
+        if (num_facets != header_num_facets)
+            BOOST_LOG_TRIVIAL(info) << "stl_open_mapped: Warning: File size doesn't match number of facets in the header: " << input_file;
+        stl.facet_start.assign(num_facets, stl_facet());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_facets), [data, &stl](const tbb::blocked_range<size_t> &range) {
+            // We assume little-endian architecture!
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                stl_facet &facet = stl.facet_start[i];
+                memcpy(&facet, data + HEADER_SIZE + i * SIZEOF_STL_FACET, SIZEOF_STL_FACET);
+#if BOOST_ENDIAN_BIG_BYTE
+                stl_internal_reverse_quads((char*)&facet, 48);
+#endif /* BOOST_ENDIAN_BIG_BYTE */
+            }
+        });
+    } else {
+        // Get the header, the first line.
+        size_t i = 0;
+        for (; i < LABEL_SIZE && data[i] != '\n'; ++ i)
+            stl.stats.header[i] = data[i];
+        if (i > 0 && stl.stats.header[i - 1] == '\r')
+            -- i;
+        stl.stats.header[i] = '\0';
+
+        // Split the file into chunks at the facet boundaries, parse the chunks in parallel.
+        static constexpr const size_t chunk_size = 4 * 1024 * 1024;
+        const char *begin = data;
+        const char *end   = data + file_size;
+        std::vector<const char*> chunk_begins { begin };
+        for (size_t offset = chunk_size; offset < file_size; offset += chunk_size)
+            if (const char *c = stl_ascii::next_facet(std::max(begin + offset, chunk_begins.back()), begin, end); c != end)
+                chunk_begins.emplace_back(c);
+        chunk_begins.emplace_back(end);
+        chunk_begins.erase(std::unique(chunk_begins.begin(), chunk_begins.end()), chunk_begins.end());
+
+        // Count the facets of each chunk first, so that the chunks are parsed straight into the final array of facets.
+        const size_t        num_chunks = chunk_begins.size() - 1;
+        std::vector<size_t> chunk_offsets(num_chunks + 1, 0);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1), [&chunk_begins, &chunk_offsets](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                chunk_offsets[i + 1] = stl_ascii::count_facets(chunk_begins[i], chunk_begins[i + 1]);
+        });
+        for (size_t i = 0; i < num_chunks; ++ i)
+            chunk_offsets[i + 1] += chunk_offsets[i];
+        stl.facet_start.resize(chunk_offsets.back());
+        std::atomic<bool> valid { true };
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks, 1), [&chunk_begins, &chunk_offsets, &stl, &valid](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                if (! stl_ascii::parse_facets(chunk_begins[i], chunk_begins[i + 1], stl.facet_start.data() + chunk_offsets[i], chunk_offsets[i + 1] - chunk_offsets[i]))
+                    valid = false;
+        });
+        if (! valid) {
+            BOOST_LOG_TRIVIAL(error) << "Something is syntactically very wrong with this ASCII STL! ";
+            return false;
+        }
+    }
+
+    stl.stats.number_of_facets    = uint32_t(stl.facet_start.size());
+    stl.stats.original_num_facets = int(stl.stats.number_of_facets);
+    stl.neighbors_start.assign(stl.stats.number_of_facets, stl_neighbors());
+
+    // The same statistics as collected by stl_facet_stats().
+    if (! stl.facet_start.empty()) {
+        const stl_facet &first = stl.facet_start.front();
+        stl_vertex diff = (first.vertex[1] - first.vertex[0]).cwiseAbs();
+        stl.stats.shortest_edge = std::max(diff(0), std::max(diff(1), diff(2)));
+        using MinMax = std::pair<stl_vertex, stl_vertex>;
+        MinMax bbox = tbb::parallel_reduce(tbb::blocked_range<size_t>(0, stl.facet_start.size()), MinMax(first.vertex[0], first.vertex[0]),
+            [&stl](const tbb::blocked_range<size_t> &range, MinMax bbox) {
+                for (size_t i = range.begin(); i < range.end(); ++ i)
+                    for (const stl_vertex &v : stl.facet_start[i].vertex) {
+                        bbox.first  = bbox.first.cwiseMin(v);
+                        bbox.second = bbox.second.cwiseMax(v);
+                    }
+                return bbox;
+            },
+            [](const MinMax &l, const MinMax &r) { return MinMax(l.first.cwiseMin(r.first), l.second.cwiseMax(r.second)); });
+        stl.stats.min = bbox.first;
+        stl.stats.max = bbox.second;
+    }
+    stl.stats.size              = stl.stats.max - stl.stats.min;
+    stl.stats.bounding_diameter = stl.stats.size.norm();
+    return true;
+}
+
 bool TriangleMesh::ReadSTLFile(const char* input_file, bool repair)
 { 
     stl_file stl;
-    if (! stl_open(&stl, input_file))
+    if (! stl_open_mapped(stl, input_file))
         return false;
     if (repair)
         trianglemesh_repair_on_import(stl);
@@ -20,6 +20,7 @@
 #include <boost/log/trivial.hpp>
 
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
 #include <tbb/scalable_allocator.h>
 
 #include <ankerl/unordered_dense.h>
@@ -381,7 +382,7 @@ private:
     std::array<CacheLineAlignedMutex, 64> m_mutexes;
 };
 
-template<typename TransformVertex>
+template<typename TransformVertex, typename EmitLine>
 void slice_facet_at_zs(
     // Scaled or unscaled vertices. transform_vertex_fn may scale zs.
     const std::vector<Vec3f>                         &mesh_vertices,
@@ -390,8 +391,11 @@ void slice_facet_at_zs(
     const Vec3i                                      &edge_ids,
     // Scaled or unscaled zs. If vertices have their zs scaled or transform_vertex_fn scales them, then zs have to be scaled as well.
     const std::vector<float>                         &zs,
-    std::vector<IntersectionLines>                   &lines,
-    LinesMutexes                                     &lines_mutex)
+    // Sweep cursor: the first layer at or above the lowest point of the previously sliced face.
+    // The faces have to be sliced in the order of their non-decreasing lowest Z.
+    std::vector<float>::const_iterator               &layer_cursor,
+    // void(size_t slice_id, const IntersectionLine &il), called in the order of increasing slice_id.
+    EmitLine                                        &&emit_line)
 {
     stl_vertex vertices[3] { transform_vertex_fn(mesh_vertices[indices(0)]), transform_vertex_fn(mesh_vertices[indices(1)]), transform_vertex_fn(mesh_vertices[indices(2)]) };
 
@@ -400,18 +404,17 @@ void slice_facet_at_zs(
     const float max_z = fmaxf(vertices[0].z(), fmaxf(vertices[1].z(), vertices[2].z()));
     
     // find layer extents
-    auto min_layer = std::lower_bound(zs.begin(), zs.end(), min_z); // first layer whose slice_z is >= min_z
-    auto max_layer = std::upper_bound(min_layer, zs.end(), max_z); // first layer whose slice_z is > max_z
+    assert(layer_cursor == zs.begin() || *(layer_cursor - 1) < min_z);
+    for (; layer_cursor != zs.end() && *layer_cursor < min_z; ++ layer_cursor) ; // first layer whose slice_z is >= min_z
     int  idx_vertex_lowest = (vertices[1].z() == min_z) ? 1 : ((vertices[2].z() == min_z) ? 2 : 0);
     
-    for (auto it = min_layer; it != max_layer; ++ it) {
+    // up to the first layer whose slice_z is > max_z
+    for (auto it = layer_cursor; it != zs.end() && *it <= max_z; ++ it) {
         IntersectionLine il;
         // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
         if (min_z != max_z && slice_facet(*it, vertices, indices, edge_ids, idx_vertex_lowest, false, il) == FacetSliceType::Slicing) {
             assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
-            size_t slice_id = it - zs.begin();
-            boost::lock_guard<std::mutex> l(lines_mutex(slice_id));
-            lines[slice_id].emplace_back(il);
+            emit_line(size_t(it - zs.begin()), il);
         }
     }
 }
@@ -425,15 +428,85 @@ static inline std::vector<IntersectionLines> slice_make_lines(
     const std::vector<float>                        &zs,
     const ThrowOnCancel                              throw_on_cancel_fn)
 {
-    std::vector<IntersectionLines>  lines(zs.size(), IntersectionLines{});
-    LinesMutexes                    lines_mutex;
+    // Sweep over the faces sorted by their lowest Z, so that the layers of a face are found by advancing a cursor over zs
+    // instead of binary searching zs for every face. Faces outside of the range of zs are dropped right away.
+    std::vector<float> vertices_z(vertices.size());
     tbb::parallel_for(
-        tbb::blocked_range<int>(0, int(indices.size())),
-        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<int> &range) {
-            for (int face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
-                if ((face_idx & 0x0ffff) == 0)
-                    throw_on_cancel_fn();
-                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], zs, lines, lines_mutex);
+        tbb::blocked_range<size_t>(0, vertices.size()),
+        [&vertices, &transform_vertex_fn, &vertices_z](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                vertices_z[i] = transform_vertex_fn(vertices[i]).z();
+        });
+    struct FaceZ {
+        float    min_z;
+        uint32_t face_idx;
+        bool operator<(const FaceZ &rhs) const { return min_z < rhs.min_z || (min_z == rhs.min_z && face_idx < rhs.face_idx); }
+    };
+    std::vector<FaceZ> faces;
+    if (! zs.empty()) {
+        faces.reserve(indices.size());
+        for (uint32_t face_idx = 0; face_idx < uint32_t(indices.size()); ++ face_idx) {
+            const stl_triangle_vertex_indices &face = indices[face_idx];
+            const float z0 = vertices_z[face(0)], z1 = vertices_z[face(1)], z2 = vertices_z[face(2)];
+            const float min_z = fminf(z0, fminf(z1, z2));
+            const float max_z = fmaxf(z0, fmaxf(z1, z2));
+            if (max_z >= zs.front() && min_z <= zs.back())
+                faces.push_back({ min_z, face_idx });
+        }
+        tbb::parallel_sort(faces.begin(), faces.end());
+    }
+    throw_on_cancel_fn();
+
+    // The sorted faces are sliced in fixed chunks, each chunk collecting its lines into its own buffer without any locking.
+    // The lines of a chunk are sorted by slice, then each slice gathers its lines from all the chunks in the order
+    // of the chunks. The lines of a slice are thus ordered independently of the thread scheduling.
+    static constexpr const size_t chunk_size = 0x04000;
+    struct SliceLine {
+        uint32_t         slice_id;
+        IntersectionLine line;
+    };
+    using SliceLines = std::vector<SliceLine, tbb::scalable_allocator<SliceLine>>;
+    std::vector<SliceLines> chunks((faces.size() + chunk_size - 1) / chunk_size);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, chunks.size()),
+        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &faces, &chunks, throw_on_cancel_fn](const tbb::blocked_range<size_t> &range) {
+            for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx) {
+                throw_on_cancel_fn();
+                SliceLines &out         = chunks[chunk_idx];
+                const auto  faces_begin = faces.begin() + chunk_idx * chunk_size;
+                const auto  faces_end   = faces.begin() + std::min(faces.size(), (chunk_idx + 1) * chunk_size);
+                auto        layer       = std::lower_bound(zs.begin(), zs.end(), faces_begin->min_z);
+                for (auto it = faces_begin; it != faces_end; ++ it)
+                    slice_facet_at_zs(vertices, transform_vertex_fn, indices[it->face_idx], face_edge_ids[it->face_idx], zs, layer,
+                        [&out](size_t slice_id, const IntersectionLine &il) { out.push_back({ uint32_t(slice_id), il }); });
+                std::stable_sort(out.begin(), out.end(), [](const SliceLine &l, const SliceLine &r) { return l.slice_id < r.slice_id; });
+            }
+        }
+    );
+
+    std::vector<IntersectionLines> lines(zs.size(), IntersectionLines{});
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, zs.size()),
+        [&chunks, &lines](const tbb::blocked_range<size_t> &range) {
+            // Ranges of the lines of this range of slices in each chunk.
+            std::vector<std::pair<typename SliceLines::const_iterator, typename SliceLines::const_iterator>> spans;
+            spans.reserve(chunks.size());
+            for (const SliceLines &chunk : chunks) {
+                auto begin = std::lower_bound(chunk.begin(), chunk.end(), range.begin(), [](const SliceLine &l, size_t slice_id) { return l.slice_id < slice_id; });
+                auto end   = std::lower_bound(begin, chunk.end(), range.end(), [](const SliceLine &l, size_t slice_id) { return l.slice_id < slice_id; });
+                if (begin != end)
+                    spans.emplace_back(begin, end);
+            }
+            for (size_t slice_id = range.begin(); slice_id < range.end(); ++ slice_id) {
+                size_t cnt = 0;
+                for (const auto &span : spans)
+                    for (auto it = span.first; it != span.second && it->slice_id == slice_id; ++ it)
+                        ++ cnt;
+                IntersectionLines &out = lines[slice_id];
+                out.reserve(cnt);
+                for (auto &span : spans)
+                    for (; span.first != span.second && span.first->slice_id == slice_id; ++ span.first)
+                        out.emplace_back(span.first->line);
             }
         }
     );
@@ -1787,22 +1860,16 @@ std::vector<Polygons> slice_mesh(
         // However facets_edges assigns a single edge ID to two triangles only, thus when factoring facets_edges out, one will have
         // to make sure that no code relies on it.
         std::vector<Vec3i> face_edge_ids = its_face_edge_ids(mesh);
-        if (zs.size() <= 1) {
-            // It likely is not worthwile to copy the vertices. Apply the transformation in place.
-            if (is_identity(params.trafo)) {
-                lines = slice_make_lines(
-                    mesh.vertices, [](const Vec3f &p) { return Vec3f(scaled<float>(p.x()), scaled<float>(p.y()), p.z()); }, 
-                    mesh.indices, face_edge_ids, zs, throw_on_cancel);
-            } else {
-                // Transform the vertices, scale up in XY, not in Z.
-                Transform3f tf = make_trafo_for_slicing(params.trafo);
-                lines = slice_make_lines(mesh.vertices, [tf](const Vec3f &p) { return tf * p; }, mesh.indices, face_edge_ids, zs, throw_on_cancel);
-            }
-        } else {
-            // Copy and scale vertices in XY, don't scale in Z. Possibly apply the transformation.
+        // Don't copy the vertices, apply the transformation in place. slice_make_lines() transforms just the Zs of all vertices
+        // up front, the rest only for the faces being sliced.
+        if (is_identity(params.trafo)) {
             lines = slice_make_lines(
-                transform_mesh_vertices_for_slicing(mesh, params.trafo), 
-                [](const Vec3f &p) { return p; },  mesh.indices, face_edge_ids, zs, throw_on_cancel);
+                mesh.vertices, [](const Vec3f &p) { return Vec3f(scaled<float>(p.x()), scaled<float>(p.y()), p.z()); }, 
+                mesh.indices, face_edge_ids, zs, throw_on_cancel);
+        } else {
+            // Transform the vertices, scale up in XY, not in Z.
+            Transform3f tf = make_trafo_for_slicing(params.trafo);
+            lines = slice_make_lines(mesh.vertices, [tf](const Vec3f &p) { return tf * p; }, mesh.indices, face_edge_ids, zs, throw_on_cancel);
         }
     }
 
@@ -5,7 +5,7 @@
 
 namespace Slic3r {
 
-std::string write_json_with_post_process(const boost::property_tree::ptree& ptree);
+std::string write_json_with_post_process(const boost::property_tree::ptree& ptree, bool pretty = true);
 
 } // namespace Slic3r
 
@@ -2964,6 +2964,7 @@ void TabPrinter::build_sla()
     optgroup = page->new_optgroup(L("Output"));
     optgroup->append_single_option_line("sla_archive_format");
     optgroup->append_single_option_line("sla_output_precision");
+    optgroup->append_single_option_line("sla_rasterizer");
 
     build_print_host_upload_group(page.get());
 
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+#include "test_data.hpp"
+
+#include <iostream>
+
+#include "libslic3r/ExtrusionEntity.hpp"
+#include "libslic3r/ExtrusionEntityCollection.hpp"
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/Utils.hpp"
+
+using namespace Slic3r;
+
+namespace {
+struct ExtrusionMemory
+{
+    size_t entities { 0 };
+    size_t points   { 0 };
+    size_t bytes    { 0 };
+};
+
+// Memory held by an extrusion entity: The entity itself, the vectors of its paths and points.
+void measure(const ExtrusionEntity &entity, ExtrusionMemory &out)
+{
+    auto measure_path = [&out](const ExtrusionPath &path) {
+        out.points += path.polyline.size();
+        out.bytes  += path.polyline.points.capacity() * sizeof(Point);
+    };
+    ++ out.entities;
+    if (const auto *collection = dynamic_cast<const ExtrusionEntityCollection*>(&entity); collection) {
+        out.bytes += sizeof(ExtrusionEntityCollection) + collection->entities.capacity() * sizeof(ExtrusionEntity*);
+        for (const ExtrusionEntity *ee : collection->entities)
+            measure(*ee, out);
+    } else if (const auto *path = dynamic_cast<const ExtrusionPath*>(&entity); path) {
+        out.bytes += sizeof(ExtrusionPath);
+        measure_path(*path);
+    } else if (const auto *multipath = dynamic_cast<const ExtrusionMultiPath*>(&entity); multipath) {
+        out.bytes += sizeof(ExtrusionMultiPath) + multipath->paths.capacity() * sizeof(ExtrusionPath);
+        for (const ExtrusionPath &path : multipath->paths)
+            measure_path(path);
+    } else if (const auto *loop = dynamic_cast<const ExtrusionLoop*>(&entity); loop) {
+        out.bytes += sizeof(ExtrusionLoop) + loop->paths.capacity() * sizeof(ExtrusionPath);
+        for (const ExtrusionPath &path : loop->paths)
+            measure_path(path);
+    }
+}
+
+ExtrusionMemory measure(const Print &print)
+{
+    ExtrusionMemory out;
+    for (const PrintObject *object : print.objects()) {
+        for (const Layer *layer : object->layers())
+            for (const LayerRegion *layerm : layer->regions()) {
+                measure(layerm->perimeters(), out);
+                measure(layerm->thin_fills(), out);
+                measure(layerm->fills(), out);
+            }
+        for (const SupportLayer *layer : object->support_layers())
+            measure(layer->support_fills, out);
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("Extrusion entities memory benchmarks", "[ExtrusionEntity][.Benchmarks]") {
+    for (Test::TestMesh mesh : { Test::TestMesh::cube_20x20x20, Test::TestMesh::overhang, Test::TestMesh::sphere_50mm, Test::TestMesh::gt2_teeth, Test::TestMesh::ipadstand }) {
+        Print print;
+        Test::init_and_process_print({ mesh }, print, {
+            { "fill_density",       0.2 },
+            { "support_material",   1 },
+            { "layer_height",       0.2 }
+        });
+        ExtrusionMemory memory = measure(print);
+        // The peak memory is cumulative over the process, it includes the meshes sliced before.
+        std::cout << Test::mesh_names.at(mesh) << ": " << memory.entities << " extrusion entities, " << memory.points << " points, " <<
+            memory.bytes / 1024 << " kB, peak memory of the process so far " << peak_memory_usage() / (1024 * 1024) << " MB" << std::endl;
+    }
+
+    Print print;
+    Test::init_and_process_print({ Test::TestMesh::sphere_50mm }, print, { { "fill_density", 0.2 }, { "support_material", 1 } });
+    const PrintObject &object = *print.objects().front();
+
+    BENCHMARK("Flatten perimeters by cloning, 50mm sphere") {
+        size_t cnt = 0;
+        for (const Layer *layer : object.layers())
+            for (const LayerRegion *layerm : layer->regions())
+                cnt += layerm->perimeters().flatten().entities.size();
+        return cnt;
+    };
+
+    BENCHMARK("Flatten perimeters by reference, 50mm sphere") {
+        size_t cnt = 0;
+        for (const Layer *layer : object.layers())
+            for (const LayerRegion *layerm : layer->regions())
+                cnt += layerm->perimeters().leaves().size();
+        return cnt;
+    };
+}
@@ -338,6 +338,28 @@ SCENARIO("ExtrusionEntityCollection: Polygon flattening", "[ExtrusionEntity]")
     }
 }
 
+TEST_CASE("ExtrusionEntityCollection: leaves", "[ExtrusionEntity]") {
+    ExtrusionEntityCollection nested;
+    nested.append(random_paths(3));
+    ExtrusionEntityCollection collection;
+    collection.append(random_path());
+    collection.append(std::move(nested));
+    collection.append(random_path());
+
+    std::vector<const ExtrusionEntity*> leaves    = collection.leaves();
+    ExtrusionEntityCollection           flattened = collection.flatten();
+    REQUIRE(leaves.size() == collection.items_count());
+    REQUIRE(leaves.size() == flattened.entities.size());
+    for (size_t i = 0; i < leaves.size(); ++ i) {
+        REQUIRE(! leaves[i]->is_collection());
+        REQUIRE(leaves[i]->first_point() == flattened.entities[i]->first_point());
+        REQUIRE(leaves[i]->last_point() == flattened.entities[i]->last_point());
+    }
+    // Not cloned, owned by the collection.
+    REQUIRE(leaves.front() == collection.entities.front());
+    REQUIRE(leaves[1] == static_cast<const ExtrusionEntityCollection*>(collection.entities[1])->entities.front());
+}
+
 TEST_CASE("ExtrusionEntityCollection: Chained path", "[ExtrusionEntity]") {
     struct Test {
         Polylines unchained;
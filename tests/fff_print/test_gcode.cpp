@@ -8,7 +8,12 @@
 #include <regex>
 #include <fstream>
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
+
 #include "libslic3r/GCode.hpp"
+#include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "libslic3r/ModelArrange.hpp"
 #include "test_data.hpp"
@@ -329,3 +334,64 @@ TEST_CASE("M201 for acceleation reset", "[GCode]") {
     INFO("M204 is not generated for repetier firmware");
     CHECK(!has_m204);
 }
+
+TEST_CASE("Parallel G-code file parsing matches serial parsing", "[GCodeReader]") {
+    // CRLF and CR line endings, a zero character inside a line and empty lines are only at the start of the file,
+    // more than 4MB of G-code follow to produce several blocks, the last line is not terminated by a new line.
+    std::string gcode =
+        "; generated by test\r\n"
+        "G28 ; home\r\n"
+        "\r\n"
+        "G1 Z0.2 F7800\r"
+        "G92 E0\n"
+        "G1 X10 Y10 E1.5 ; comment\r\n"
+        "\n";
+    gcode += "G1 X1";
+    gcode += '\0';
+    gcode += " Y2 E3\r\n";
+    for (int i = 0; i < 200000; ++ i)
+        gcode += "G1 X" + std::to_string(i % 200) + ".125 Y" + std::to_string(i % 117) + ".5 E0.0" + std::to_string(i % 10) + "\n";
+    gcode += "G1 X0 Y0 E1";
+
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    {
+        boost::nowide::ofstream out(path.string(), std::ios::binary);
+        out.write(gcode.data(), gcode.size());
+    }
+
+    struct ParsedLine {
+        std::string raw;
+        uint32_t    mask;
+        float       axis[4];
+        float       position[4];
+        bool operator==(const ParsedLine &rhs) const {
+            return raw == rhs.raw && mask == rhs.mask && std::equal(axis, axis + 4, rhs.axis) && std::equal(position, position + 4, rhs.position);
+        }
+    };
+    auto parse = [&path](bool parallel, std::vector<std::vector<size_t>> &lines_ends) {
+        std::vector<ParsedLine> out;
+        GCodeReader reader;
+        auto callback = [&out](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+            ParsedLine &l = out.emplace_back();
+            l.raw  = line.raw();
+            l.mask = (line.has_x() ? 1 : 0) | (line.has_y() ? 2 : 0) | (line.has_z() ? 4 : 0) | (line.has_e() ? 8 : 0);
+            l.axis[0] = line.x(); l.axis[1] = line.y(); l.axis[2] = line.z(); l.axis[3] = line.e();
+            l.position[0] = reader.x(); l.position[1] = reader.y(); l.position[2] = reader.z(); l.position[3] = reader.e();
+        };
+        REQUIRE((parallel ? reader.parse_file_parallel(path.string(), callback, lines_ends) : reader.parse_file(path.string(), callback, lines_ends)));
+        return out;
+    };
+    std::vector<std::vector<size_t>> lines_ends_serial, lines_ends_parallel;
+    const std::vector<ParsedLine> serial   = parse(false, lines_ends_serial);
+    const std::vector<ParsedLine> parallel = parse(true,  lines_ends_parallel);
+    boost::nowide::remove(path.string().c_str());
+
+    CHECK(serial.size() > 200000);
+    CHECK(serial.back().raw == "G1 X0 Y0 E1");
+    CHECK(lines_ends_parallel == lines_ends_serial);
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++ i) {
+        INFO("Line " << i << ": " << serial[i].raw);
+        REQUIRE(parallel[i] == serial[i]);
+    }
+}
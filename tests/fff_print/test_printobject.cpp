@@ -3,6 +3,7 @@
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/Model.hpp"
 
 #include "test_data.hpp"
 
@@ -87,3 +88,64 @@ SCENARIO("PrintObject: object layer heights", "[PrintObject]") {
 #endif
     }
 }
+
+SCENARIO("PrintObject: changing a layer range modifier", "[PrintObject]") {
+    GIVEN("20mm cube with a layer range modifier from 15mm to 20mm") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "first_layer_height", 0.3 },
+            { "layer_height",       0.3 },
+            { "top_solid_layers",   3 }
+        });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        ModelConfig &range_config = model.objects.front()->layer_config_ranges[{ 15., 20. }];
+        range_config.set_key_value("layer_height", new ConfigOptionFloat(0.3));
+        range_config.set_key_value("top_fill_pattern", new ConfigOptionEnum<InfillPattern>(ipRectilinear));
+        print.apply(model, config);
+        print.process();
+
+        auto fills_of_layer = [](const Layer &layer) {
+            std::vector<const ExtrusionEntity*> out;
+            for (const LayerRegion *layerm : layer.regions())
+                out.insert(out.end(), layerm->fills().entities.begin(), layerm->fills().entities.end());
+            return out;
+        };
+        const PrintObject &object = *print.objects().front();
+        std::vector<std::vector<const ExtrusionEntity*>> fills_old;
+        for (const Layer *layer : object.layers())
+            fills_old.emplace_back(fills_of_layer(*layer));
+
+        WHEN("the top fill pattern of the modifier is changed") {
+            range_config.set_key_value("top_fill_pattern", new ConfigOptionEnum<InfillPattern>(ipConcentric));
+            print.apply(model, config);
+            THEN("infill is invalidated, preparation of infill is not") {
+                REQUIRE(object.is_step_done(posPrepareInfill));
+                REQUIRE(! object.is_step_done(posInfill));
+            }
+            print.process();
+            THEN("layers below the modifier keep their infill") {
+                for (const Layer *layer : object.layers())
+                    if (layer->slice_z < 14.)
+                        REQUIRE(fills_of_layer(*layer) == fills_old[layer->id()]);
+            }
+            THEN("infill is the same as of an object sliced from scratch") {
+                Slic3r::Print print_new;
+                print_new.apply(model, config);
+                print_new.set_status_silent();
+                print_new.process();
+                SpanOfConstPtrs<Layer> layers     = object.layers();
+                SpanOfConstPtrs<Layer> layers_new = print_new.objects().front()->layers();
+                REQUIRE(layers.size() == layers_new.size());
+                for (size_t i = 0; i < layers.size(); ++ i) {
+                    std::vector<const ExtrusionEntity*> fills     = fills_of_layer(*layers[i]);
+                    std::vector<const ExtrusionEntity*> fills_new = fills_of_layer(*layers_new[i]);
+                    REQUIRE(fills.size() == fills_new.size());
+                    for (size_t j = 0; j < fills.size(); ++ j)
+                        REQUIRE(fills[j]->total_volume() == Approx(fills_new[j]->total_volume()));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/libslic3r.h"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/SlicingService.hpp"
+#include "libslic3r/Format/3mf.hpp"
+#include "libslic3r/Format/STL.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <sstream>
+
+using namespace Slic3r;
+
+namespace pt = boost::property_tree;
+
+// Pass a single request to the service, return the parsed response.
+static pt::ptree handle_request(SlicingService &service, const pt::ptree &request)
+{
+    std::ostringstream os;
+    pt::write_json(os, request, false);
+    std::istringstream is(service.handle(os.str()));
+    pt::ptree response;
+    pt::read_json(is, response);
+    return response;
+}
+
+SCENARIO("Slicing service", "[SlicingService]") {
+    GIVEN("FFF slicing service and a cube in the middle of the bed") {
+        const boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        boost::filesystem::create_directories(dir);
+        const std::string model_path = (dir / "cube.stl").string();
+        TriangleMesh cube = make_cube(20., 20., 20.);
+        cube.translate(90.f, 90.f, 0.f);
+        REQUIRE(store_stl(model_path.c_str(), &cube, true));
+
+        DynamicPrintConfig    config = DynamicPrintConfig::full_print_config();
+        arr2::ArrangeBed      bed    = arr2::InfiniteBed{};
+        arr2::ArrangeSettings arrange_cfg;
+        SlicingService        service(config, ptFFF, false, true, bed, arrange_cfg);
+
+        WHEN("the model is sliced by two requests") {
+            pt::ptree request;
+            request.put("model", model_path);
+            request.put("output", (dir / "cube.gcode").string());
+            pt::ptree response1 = handle_request(service, request);
+            request.put("config.layer_height", "0.3");
+            pt::ptree response2 = handle_request(service, request);
+            THEN("both requests export the G-code") {
+                REQUIRE(response1.get<bool>("success"));
+                REQUIRE(response2.get<bool>("success"));
+                REQUIRE(boost::filesystem::exists(response2.get<std::string>("output")));
+            }
+            THEN("the model is loaded just once") {
+                REQUIRE(service.num_served_models() == 1);
+            }
+        }
+        WHEN("a project file with a configuration is requested") {
+            const std::string project_path = (dir / "cube.3mf").string();
+            Model model;
+            model.add_object()->add_volume(cube);
+            model.add_default_instances();
+            REQUIRE(store_3mf(project_path.c_str(), &model, &config, false));
+            pt::ptree request;
+            request.put("model", project_path);
+            pt::ptree response = handle_request(service, request);
+            THEN("the request is rejected and the model is not kept") {
+                REQUIRE(! response.get<bool>("success"));
+                REQUIRE(response.get<std::string>("error").find("not supported") != std::string::npos);
+                REQUIRE(service.num_served_models() == 0);
+            }
+        }
+        WHEN("a file which does not exist is requested") {
+            pt::ptree request;
+            request.put("model", (dir / "missing.stl").string());
+            pt::ptree response = handle_request(service, request);
+            THEN("the request is rejected and no model is kept") {
+                REQUIRE(! response.get<bool>("success"));
+                REQUIRE(service.num_served_models() == 0);
+            }
+        }
+
+        boost::filesystem::remove_all(dir);
+    }
+}
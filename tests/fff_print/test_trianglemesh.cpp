@@ -357,3 +357,41 @@ TEST_CASE("Profile test for issue #4486 - files take forever to slice") {
 
 }
 #endif //BUILD_PROFILE
+
+TEST_CASE("Slicing a mesh at many heights matches slicing it at each height on its own", "[TriangleMeshSlicer]") {
+    // About 40k triangles, thus the faces are sliced in several chunks.
+    indexed_triangle_set sphere = its_make_sphere(10., 2. * PI / 200.);
+    std::vector<float> zs;
+    for (float z = -9.95f; z < 10.f; z += 0.1f)
+        zs.emplace_back(z);
+
+    std::vector<Polygons> slices = slice_mesh(sphere, zs, MeshSlicingParams{});
+    REQUIRE(slices.size() == zs.size());
+    for (size_t i = 0; i < zs.size(); ++ i) {
+        INFO("z = " << zs[i]);
+        // With a single slicing plane, the lines of all the chunks belong to the same slice,
+        // so the lines of other slices cannot get mixed in or lost on the way.
+        std::vector<Polygons> reference = slice_mesh(sphere, std::vector<float>{ zs[i] }, MeshSlicingParams{});
+        REQUIRE(reference.size() == 1);
+        REQUIRE(! reference.front().empty());
+        REQUIRE(slices[i] == reference.front());
+        // The single threaded slicing of a single plane does not collect the lines in chunks.
+        Polygons serial = slice_mesh(sphere, zs[i], MeshSlicingParams{});
+        REQUIRE(slices[i].size() == serial.size());
+        REQUIRE(area(slices[i]) == Approx(area(serial)));
+    }
+    INFO("Slicing is deterministic");
+    REQUIRE(slices == slice_mesh(sphere, zs, MeshSlicingParams{}));
+}
+
+TEST_CASE("Slicing large meshes benchmark", "[TriangleMeshSlicer][.Benchmarks]") {
+    // About a million of triangles sliced at fine layer heights.
+    indexed_triangle_set sphere = its_make_sphere(50., 2. * PI / 1000.);
+    std::vector<float> zs;
+    for (float z = -49.99f; z < 50.f; z += 0.025f)
+        zs.emplace_back(z);
+
+    BENCHMARK("slice_mesh") {
+        return slice_mesh(sphere, zs, MeshSlicingParams{});
+    };
+}
@@ -3,8 +3,19 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/3mf.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/miniz_extension.hpp"
 
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions/message.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+
+#include <algorithm>
+#include <sstream>
 
 using namespace Slic3r;
 
@@ -131,3 +142,166 @@ SCENARIO("2D convex hull of sinking object", "[3mf]") {
     }
 }
 
+
+// Model file of a 3MF archive with an object and a build item for each of the meshes.
+static std::string model_file(const std::vector<indexed_triangle_set> &meshes)
+{
+    std::ostringstream out;
+    out.precision(9);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out << "<model unit=\"millimeter\" xml:lang=\"en-US\" xmlns=\"http://schemas.microsoft.com/3dmanufacturing/core/2015/02\">\n";
+    out << " <resources>\n";
+    for (size_t i = 0; i < meshes.size(); ++ i) {
+        out << "  <object id=\"" << i + 1 << "\" type=\"model\">\n";
+        out << "   <mesh>\n";
+        out << "    <vertices>\n";
+        for (const stl_vertex &v : meshes[i].vertices)
+            out << "     <vertex x=\"" << v.x() << "\" y=\"" << v.y() << "\" z=\"" << v.z() << "\"/>\n";
+        out << "    </vertices>\n";
+        out << "    <triangles>\n";
+        for (const stl_triangle_vertex_indices &t : meshes[i].indices)
+            out << "     <triangle v1=\"" << t.x() << "\" v2=\"" << t.y() << "\" v3=\"" << t.z() << "\"/>\n";
+        out << "    </triangles>\n";
+        out << "   </mesh>\n";
+        out << "  </object>\n";
+    }
+    out << " </resources>\n";
+    out << " <build>\n";
+    for (size_t i = 0; i < meshes.size(); ++ i)
+        out << "  <item objectid=\"" << i + 1 << "\"/>\n";
+    out << " </build>\n";
+    out << "</model>\n";
+    return out.str();
+}
+
+// Replaces the first occurence of what following after in str, returns the position of the replacement.
+static size_t replace_after(std::string &str, const std::string &after, const std::string &what, const std::string &with)
+{
+    size_t pos = str.find(after);
+    REQUIRE(pos != std::string::npos);
+    pos = str.find(what, pos);
+    REQUIRE(pos != std::string::npos);
+    str.replace(pos, what.size(), with);
+    return pos;
+}
+
+// Writes and loads back a 3MF archive containing just the given model file.
+static bool load_model_file(const std::string &model_file, Model &model)
+{
+    std::string path = std::string(TEST_DATA_DIR) + "/test_3mf/model_file.3mf";
+    {
+        const std::string rels =
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">\n"
+            " <Relationship Target=\"/3D/3dmodel.model\" Id=\"rel-1\" Type=\"http://schemas.microsoft.com/3dmanufacturing/2013/01/3dmodel\"/>\n"
+            "</Relationships>";
+        mz_zip_archive archive;
+        mz_zip_zero_struct(&archive);
+        REQUIRE(open_zip_writer(&archive, path));
+        REQUIRE(mz_zip_writer_add_mem(&archive, "_rels/.rels", rels.data(), rels.size(), MZ_DEFAULT_COMPRESSION));
+        REQUIRE(mz_zip_writer_add_mem(&archive, "3D/3dmodel.model", model_file.data(), model_file.size(), MZ_DEFAULT_COMPRESSION));
+        REQUIRE(mz_zip_writer_finalize_archive(&archive));
+        REQUIRE(close_zip_writer(&archive));
+    }
+    DynamicPrintConfig config;
+    ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+    bool ret = load_3mf(path.c_str(), config, ctxt, &model, false);
+    boost::filesystem::remove(path);
+    return ret;
+}
+
+static bool same_meshes(const Model &model1, const Model &model2)
+{
+    if (model1.objects.size() != model2.objects.size())
+        return false;
+    for (size_t i = 0; i < model1.objects.size(); ++ i) {
+        const indexed_triangle_set &its1 = model1.objects[i]->volumes.front()->mesh().its;
+        const indexed_triangle_set &its2 = model2.objects[i]->volumes.front()->mesh().its;
+        if (its1.vertices != its2.vertices || its1.indices != its2.indices)
+            return false;
+    }
+    return true;
+}
+
+// The 3MF importer reports the parse errors to the log only.
+class LogRecords : public boost::log::sinks::basic_sink_backend<boost::log::sinks::synchronized_feeding>
+{
+public:
+    void consume(const boost::log::record_view &rec) {
+        if (auto message = rec[boost::log::expressions::smessage])
+            messages.emplace_back(*message);
+    }
+
+    std::vector<std::string> messages;
+};
+
+SCENARIO("Parsing the meshes of a 3mf file ahead of the XML parser", "[3mf]") {
+    GIVEN("model file with multiple objects") {
+        std::vector<indexed_triangle_set> meshes{ its_make_cube(10., 20., 30.), its_make_cylinder(5., 10.), its_make_sphere(8., PI / 32.) };
+        std::string xml = model_file(meshes);
+
+        Model model;
+        REQUIRE(load_model_file(xml, model));
+
+        WHEN("the content of the meshes needs the XML parser") {
+            // Meshes with comments are left to expat, parsing them element by element as if the file was streamed.
+            std::string serial_xml = xml;
+            boost::algorithm::replace_all(serial_xml, "<mesh>", "<mesh><!-- parsed by expat -->");
+            Model serial_model;
+            REQUIRE(load_model_file(serial_xml, serial_model));
+            THEN("vertex and triangle counts match the serial parse") {
+                REQUIRE(model.objects.size() == meshes.size());
+                REQUIRE(serial_model.objects.size() == meshes.size());
+                for (size_t i = 0; i < meshes.size(); ++ i) {
+                    const indexed_triangle_set &its        = model.objects[i]->volumes.front()->mesh().its;
+                    const indexed_triangle_set &serial_its = serial_model.objects[i]->volumes.front()->mesh().its;
+                    REQUIRE(its.vertices.size() == meshes[i].vertices.size());
+                    REQUIRE(its.indices.size() == meshes[i].indices.size());
+                    REQUIRE(its.vertices.size() == serial_its.vertices.size());
+                    REQUIRE(its.indices.size() == serial_its.indices.size());
+                }
+                REQUIRE(same_meshes(model, serial_model));
+            }
+        }
+        WHEN("vertex and triangle elements contain character references") {
+            // Well-formed XML, which is left to expat: the first character of an attribute value replaced by a character reference.
+            std::string xml2 = xml;
+            auto char_ref = [&xml2](const std::string &after, const std::string &what) {
+                const size_t pos = replace_after(xml2, after, what, what) + what.size();
+                xml2.replace(pos, 1, "&#" + std::to_string(int(xml2[pos])) + ";");
+            };
+            char_ref("<object id=\"2\"", "<vertex x=\"");
+            char_ref("<object id=\"3\"", "<triangle v1=\"");
+            Model model2;
+            REQUIRE(load_model_file(xml2, model2));
+            THEN("the meshes are loaded the same") {
+                REQUIRE(same_meshes(model, model2));
+            }
+        }
+        WHEN("an element is malformed") {
+            // Attributes not separated by white space, a repeated attribute and a broken empty element tag are not well-formed XML.
+            auto [after, what, with] = GENERATE(table<std::string, std::string, std::string>({
+                { "<object id=\"2\"", "\" y=\"", "\"y=\"" },
+                { "<object id=\"3\"", "\" v2=\"", "\" v1=\"" },
+                { "<object id=\"3\"", "\"/>", "\"/ >" },
+                { "<build>", "<item objectid=\"2\"/>", "<item objectid=\"2\"x=\"\"/>" }
+            }));
+            std::string malformed = xml;
+            const size_t pos  = replace_after(malformed, after, what, with);
+            const int    line = 1 + int(std::count(malformed.begin(), malformed.begin() + pos, '\n'));
+
+            auto sink = boost::make_shared<boost::log::sinks::synchronous_sink<LogRecords>>();
+            boost::log::core::get()->add_sink(sink);
+            Model malformed_model;
+            bool ret = load_model_file(malformed, malformed_model);
+            boost::log::core::get()->remove_sink(sink);
+
+            THEN("the XML parser reports the error at the line of the malformed element") {
+                REQUIRE(! ret);
+                const std::vector<std::string> &messages = sink->locked_backend()->messages;
+                REQUIRE(std::any_of(messages.begin(), messages.end(), [line](const std::string &message) {
+                    return boost::algorithm::ends_with(message, "at line " + std::to_string(line)); }));
+            }
+        }
+    }
+}
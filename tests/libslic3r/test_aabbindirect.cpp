@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <catch2/catch.hpp>
 #include <test_utils.hpp>
 
@@ -61,6 +63,181 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+// Rays shot from a grid of origins in a fan of directions, including the axis aligned directions,
+// for which the inverse direction contains infinities.
+static void make_test_rays(const BoundingBoxf3 &bbox, std::vector<Vec3d> &origins, std::vector<Vec3d> &dirs)
+{
+    const int num_steps = 9;
+    Vec3d     size = bbox.size();
+    for (int i = 0; i < num_steps; ++ i)
+        for (int j = 0; j < num_steps; ++ j) {
+            Vec3d origin = bbox.min + Vec3d(size.x() * i / (num_steps - 1), size.y() * j / (num_steps - 1), 0.5 * size.z()) * 1.2 - 0.1 * size;
+            for (const Vec3d &dir : { Vec3d(0., 0., 1.), Vec3d(0., 0., -1.), Vec3d(1., 0., 0.), Vec3d(0.3, -0.2, 1.), Vec3d(-0.5, 0.7, -0.1), Vec3d(0.1, 0.1, 0.1) }) {
+                origins.emplace_back(origin);
+                dirs.emplace_back(dir.normalized());
+            }
+        }
+}
+
+TEST_CASE("Casting a batch of rays matches casting the rays one by one", "[AABBIndirect]")
+{
+    TriangleMesh tmesh = make_sphere(1., PI / 20.);
+    tmesh.merge(make_cube(1., 1., 1.));
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(tmesh.its.vertices, tmesh.its.indices);
+
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    make_test_rays(tmesh.bounding_box(), origins, dirs);
+    // Number of rays not divisible by the packet size.
+    origins.pop_back();
+    dirs.pop_back();
+
+    SECTION("First hit") {
+        std::vector<igl::Hit> hits;
+        size_t num_hit = AABBTreeIndirect::intersect_rays_first_hit(tmesh.its.vertices, tmesh.its.indices, tree, origins, dirs, hits);
+        REQUIRE(hits.size() == origins.size());
+        size_t num_hit_one_by_one = 0;
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            igl::Hit hit;
+            bool intersected = AABBTreeIndirect::intersect_ray_first_hit(tmesh.its.vertices, tmesh.its.indices, tree, origins[i], dirs[i], hit);
+            REQUIRE(intersected == (hits[i].id != -1));
+            if (intersected) {
+                ++ num_hit_one_by_one;
+                // Hits of equidistant triangles sharing an edge may be returned in a different order.
+                REQUIRE(hits[i].t == Approx(hit.t));
+            }
+        }
+        REQUIRE(num_hit > 0);
+        REQUIRE(num_hit == num_hit_one_by_one);
+    }
+
+    SECTION("All hits") {
+        std::vector<std::vector<igl::Hit>> hits;
+        size_t num_hit = AABBTreeIndirect::intersect_rays_all_hits(tmesh.its.vertices, tmesh.its.indices, tree, origins, dirs, hits);
+        REQUIRE(hits.size() == origins.size());
+        size_t num_hit_one_by_one = 0;
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            std::vector<igl::Hit> ray_hits;
+            if (AABBTreeIndirect::intersect_ray_all_hits(tmesh.its.vertices, tmesh.its.indices, tree, origins[i], dirs[i], ray_hits))
+                ++ num_hit_one_by_one;
+            REQUIRE(hits[i].size() == ray_hits.size());
+            for (size_t j = 0; j < ray_hits.size(); ++ j)
+                REQUIRE(hits[i][j].t == Approx(ray_hits[j].t));
+        }
+        REQUIRE(num_hit > 0);
+        REQUIRE(num_hit == num_hit_one_by_one);
+    }
+
+    SECTION("Empty tree") {
+        std::vector<igl::Hit> hits;
+        REQUIRE(AABBTreeIndirect::intersect_rays_first_hit(tmesh.its.vertices, tmesh.its.indices, AABBTreeIndirect::Tree3f(), origins, dirs, hits) == 0);
+        REQUIRE(hits.size() == origins.size());
+        REQUIRE(std::all_of(hits.begin(), hits.end(), [](const igl::Hit &hit) { return hit.id == -1; }));
+    }
+}
+
+TEST_CASE("Casting axis aligned rays from the vertex and bounding box coordinates", "[AABBIndirect]")
+{
+    // A ray parallel to a slab of a bounding box with its origin on a slab plane produces 0 * inf = NaN
+    // in the slab test. Such a ray shall miss the box both in the single ray and in the batch query.
+    TriangleMesh tmesh = make_cube(1., 1., 1.);
+    TriangleMesh cube2 = make_cube(1., 1., 1.);
+    cube2.translate(2.f, 0.f, 0.f);
+    tmesh.merge(cube2);
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(tmesh.its.vertices, tmesh.its.indices);
+
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    for (double x : { -1., 0., 0.5, 1., 2., 2.5, 3., 4. })
+        for (double y : { -1., 0., 0.5, 1., 2. })
+            for (double z : { -1., 0., 0.5, 1., 2. })
+                for (const Vec3d &dir : { Vec3d(1., 0., 0.), Vec3d(-1., 0., 0.), Vec3d(0., 1., 0.), Vec3d(0., -1., 0.), Vec3d(0., 0., 1.), Vec3d(0., 0., -1.) }) {
+                    origins.emplace_back(x, y, z);
+                    dirs.emplace_back(dir);
+                }
+
+    std::vector<igl::Hit> hits;
+    AABBTreeIndirect::intersect_rays_first_hit(tmesh.its.vertices, tmesh.its.indices, tree, origins, dirs, hits);
+    std::vector<std::vector<igl::Hit>> all_hits;
+    AABBTreeIndirect::intersect_rays_all_hits(tmesh.its.vertices, tmesh.its.indices, tree, origins, dirs, all_hits);
+    REQUIRE(hits.size() == origins.size());
+    REQUIRE(all_hits.size() == origins.size());
+    for (size_t i = 0; i < origins.size(); ++ i) {
+        igl::Hit hit;
+        bool intersected = AABBTreeIndirect::intersect_ray_first_hit(tmesh.its.vertices, tmesh.its.indices, tree, origins[i], dirs[i], hit);
+        REQUIRE(intersected == (hits[i].id != -1));
+        if (intersected)
+            REQUIRE(hits[i].t == Approx(hit.t));
+        std::vector<igl::Hit> ray_hits;
+        AABBTreeIndirect::intersect_ray_all_hits(tmesh.its.vertices, tmesh.its.indices, tree, origins[i], dirs[i], ray_hits);
+        REQUIRE(all_hits[i].size() == ray_hits.size());
+    }
+
+    auto first_hit = [&](const Vec3d &origin, const Vec3d &dir) {
+        size_t i = std::find_if(origins.begin(), origins.end(), [&origin](const Vec3d &o) { return o == origin; }) - origins.begin();
+        for (; i < origins.size() && origins[i] == origin; ++ i)
+            if (dirs[i] == dir)
+                return hits[i];
+        return igl::Hit{ -1, -1, 0.f, 0.f, 0.f };
+    };
+    // Ray through the middle of the faces hits both cubes.
+    REQUIRE(first_hit(Vec3d(-1., 0.5, 0.5), Vec3d(1., 0., 0.)).t == Approx(1.));
+    REQUIRE(first_hit(Vec3d(4., 0.5, 0.5), Vec3d(-1., 0., 0.)).t == Approx(1.));
+    // Rays sliding along the faces of the cubes and of the bounding box of the mesh miss.
+    REQUIRE(first_hit(Vec3d(-1., 1., 0.5), Vec3d(1., 0., 0.)).id == -1);
+    REQUIRE(first_hit(Vec3d(0.5, 0., -1.), Vec3d(0., 0., 1.)).id == -1);
+    REQUIRE(first_hit(Vec3d(1., 0.5, -1.), Vec3d(0., 0., 1.)).id == -1);
+}
+
+TEST_CASE("Casting a batch of rays vs. casting the rays one by one time Benchmark", "[AABBIndirect][.Benchmark]")
+{
+    TriangleMesh tmesh = make_sphere(10., PI / 360.);
+    for (int i = 0; i < 5; ++ i) {
+        TriangleMesh sphere = make_sphere(2., PI / 180.);
+        sphere.translate(float(4 * i - 8), 0.f, 10.f);
+        tmesh.merge(sphere);
+    }
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(tmesh.its.vertices, tmesh.its.indices);
+
+    // Rays starting above the large sphere, shot into a hemisphere, similarly to the seam visibility estimation.
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    for (int i = 0; i < 10000; ++ i) {
+        double angle  = 2. * PI * i / 10000.;
+        Vec3d  normal = Vec3d(cos(angle), sin(angle), cos(13. * angle)).normalized();
+        Vec3d  origin = normal * 10.01;
+        Vec3d  side   = normal.unitOrthogonal();
+        for (int j = 0; j < 16; ++ j) {
+            double elevation = (j / 4 + 0.5) / 4.;
+            double azimuth   = 2. * PI * (j % 4 + 0.5) / 4.;
+            origins.emplace_back(origin);
+            dirs.emplace_back((normal * elevation + (Eigen::AngleAxisd(azimuth, normal) * side) * sqrt(1. - elevation * elevation)).normalized());
+        }
+    }
+
+    using namespace std::chrono;
+    std::cout << "casting " << origins.size() << " rays over " << tmesh.its.indices.size() << " triangles..." << std::endl;
+    size_t num_hit_one_by_one = 0;
+    {
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        igl::Hit hit;
+        for (size_t i = 0; i < origins.size(); ++ i)
+            if (AABBTreeIndirect::intersect_ray_first_hit(tmesh.its.vertices, tmesh.its.indices, tree, origins[i], dirs[i], hit))
+                ++ num_hit_one_by_one;
+        duration<double> time_span = duration_cast<duration<double>>(high_resolution_clock::now() - t1);
+        std::cout << "Casting the rays one by one took " << time_span.count() << " seconds." << std::endl;
+    }
+    size_t num_hit_batch = 0;
+    {
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        std::vector<igl::Hit> hits;
+        num_hit_batch = AABBTreeIndirect::intersect_rays_first_hit(tmesh.its.vertices, tmesh.its.indices, tree, origins, dirs, hits);
+        duration<double> time_span = duration_cast<duration<double>>(high_resolution_clock::now() - t1);
+        std::cout << "Casting the rays as a batch took " << time_span.count() << " seconds." << std::endl;
+    }
+    REQUIRE(num_hit_batch == num_hit_one_by_one);
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
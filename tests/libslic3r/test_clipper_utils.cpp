@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 
+#include <chrono>
 #include <numeric>
 #include <iostream>
 #include <boost/filesystem.hpp>
@@ -382,3 +383,85 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Pooled Clipper engines", "[ClipperUtils]") {
+    const Polygon square { { 0, 0 }, { scaled(10.), 0 }, { scaled(10.), scaled(10.) }, { 0, scaled(10.) } };
+    Polygon hole = square;
+    hole.scale(0.5);
+    hole.translate(scaled(2.5), scaled(2.5));
+
+    SECTION("Released engine is reused in its default state") {
+        const ClipperLib::Clipper *engine = nullptr;
+        {
+            ClipperUtils::PooledClipper clipper;
+            engine = &(*clipper);
+            clipper->ReverseSolution(true);
+            clipper->StrictlySimple(true);
+            clipper->AddPath(square.points, ClipperLib::ptSubject, true);
+        }
+        ClipperUtils::PooledClipper clipper;
+        REQUIRE(&(*clipper) == engine);
+        REQUIRE(! clipper->ReverseSolution());
+        REQUIRE(! clipper->StrictlySimple());
+        ClipperLib::Paths out;
+        clipper->Execute(ClipperLib::ctUnion, out, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        REQUIRE(out.empty());
+    }
+
+    SECTION("Nested engines are distinct") {
+        ClipperUtils::PooledClipper outer;
+        ClipperUtils::PooledClipper inner;
+        REQUIRE(&(*outer) != &(*inner));
+    }
+
+    SECTION("Repeated operations produce the same results") {
+        const ExPolygons reference_diff   = diff_ex(square, hole);
+        const Polygons   reference_offset = offset(reference_diff, - scaled(0.5));
+        for (int i = 0; i < 10; ++ i) {
+            ExPolygons result = diff_ex(square, hole);
+            REQUIRE(result == reference_diff);
+            REQUIRE(offset(result, - scaled(0.5)) == reference_offset);
+        }
+    }
+}
+
+TEST_CASE("Pooled vs. newly constructed Clipper engines time Benchmark", "[ClipperUtils][.Benchmark]") {
+    Polygons polygons;
+    for (int i = 0; i < 20; ++ i) {
+        Polygon circle;
+        for (int j = 0; j < 64; ++ j) {
+            double angle = 2. * PI * j / 64.;
+            circle.points.emplace_back(scaled(10. * i + 5. * cos(angle)), scaled(5. * sin(angle)));
+        }
+        polygons.emplace_back(std::move(circle));
+    }
+
+    auto do_union = [&polygons](ClipperLib::Clipper &clipper) {
+        ClipperLib::Paths out;
+        clipper.AddPaths(ClipperUtils::PolygonsProvider(polygons), ClipperLib::ptSubject, true);
+        clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        return out.size();
+    };
+
+    const int num_runs = 20000;
+    using namespace std::chrono;
+    std::cout << "union of " << polygons.size() << " polygons " << num_runs << " times..." << std::endl;
+    {
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        for (int i = 0; i < num_runs; ++ i) {
+            ClipperLib::Clipper clipper;
+            do_union(clipper);
+        }
+        duration<double> time_span = duration_cast<duration<double>>(high_resolution_clock::now() - t1);
+        std::cout << "New engine each time took " << time_span.count() << " seconds." << std::endl;
+    }
+    {
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        for (int i = 0; i < num_runs; ++ i) {
+            ClipperUtils::PooledClipper clipper;
+            do_union(*clipper);
+        }
+        duration<double> time_span = duration_cast<duration<double>>(high_resolution_clock::now() - t1);
+        std::cout << "Pooled engine took " << time_span.count() << " seconds." << std::endl;
+    }
+}
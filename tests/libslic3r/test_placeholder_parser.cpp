@@ -65,6 +65,22 @@ SCENARIO("Placeholder parser scripting", "[PlaceholderParser]") {
         }
     }
 
+    // Templates are compiled once into text, legacy variable and macro segments.
+    SECTION("text, legacy variables and macros mixed") { REQUIRE(parser.process("G1 S[temperature] ; {temperature[bar]} [bar]\n[temperature_[foo]] done") == "G1 S357 ; 363 2\n357 done"); }
+    SECTION("processing a template repeatedly") {
+        const std::string templ = "M104 S{temperature[bar] + 1} ; [gcode_flavor]";
+        REQUIRE(parser.process(templ) == "M104 S364 ; marlin");
+        REQUIRE(parser.process(templ) == "M104 S364 ; marlin");
+    }
+    SECTION("error is reported at the line of the full template") {
+        try {
+            parser.process("G28\nG1 S[temperature]\n{1 + }\n");
+            FAIL("No exception thrown");
+        } catch (const std::runtime_error &ex) {
+            REQUIRE(std::string(ex.what()).find("Parsing error at line 3") != std::string::npos);
+        }
+    }
+
     // Test the math expressions.
     SECTION("math: 2*3") { REQUIRE(parser.process("{2*3}") == "6"); }
     SECTION("math: 2*3/6") { REQUIRE(parser.process("{2*3/6}") == "1"); }
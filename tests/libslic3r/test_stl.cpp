@@ -2,6 +2,10 @@
 
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/cstdio.hpp>
 
 using namespace Slic3r;
 
@@ -55,3 +59,32 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+SCENARIO("Reading a large STL file matches admesh", "[stl]") {
+	// Large enough for the ASCII file to be parsed in several chunks.
+	indexed_triangle_set sphere = its_make_sphere(10., 2. * PI / 200.);
+	for (bool binary : { false, true }) {
+		GIVEN(binary ? "in binary format" : "in ASCII format") {
+			boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			REQUIRE((binary ? its_write_stl_binary(temp.string().c_str(), "sphere", sphere) : its_write_stl_ascii(temp.string().c_str(), "sphere", sphere)));
+			WHEN("STL file is read") {
+				TriangleMesh mesh;
+				REQUIRE(mesh.ReadSTLFile(temp.string().c_str()));
+				THEN("the facets and the shared vertices are the same as read by admesh") {
+					stl_file stl;
+					REQUIRE(stl_open(&stl, temp.string().c_str()));
+					stl_check_facets_exact(&stl);
+					indexed_triangle_set its;
+					stl_generate_shared_vertices(&stl, its);
+					REQUIRE(mesh.facets_count() == sphere.indices.size());
+					REQUIRE(mesh.its == its);
+					REQUIRE(mesh.stats().min == stl.stats.min);
+					REQUIRE(mesh.stats().max == stl.stats.max);
+					REQUIRE(mesh.stats().open_edges == 0);
+					REQUIRE(mesh.stats().number_of_parts == 1);
+				}
+			}
+			boost::nowide::remove(temp.string().c_str());
+		}
+	}
+}
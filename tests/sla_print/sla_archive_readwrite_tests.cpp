@@ -6,8 +6,15 @@
 #include "libslic3r/Format/SLAArchiveFormatRegistry.hpp"
 #include "libslic3r/Format/SLAArchiveWriter.hpp"
 #include "libslic3r/Format/SLAArchiveReader.hpp"
+#include "libslic3r/Format/SL1.hpp"
+#include "libslic3r/Format/AnycubicSLA.hpp"
+#include "libslic3r/miniz_extension.hpp"
+#include "libslic3r/Utils.hpp"
 
 #include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <cstring>
 
 using namespace Slic3r;
 
@@ -68,3 +75,151 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         }
     }
 }
+
+// Rasterizes a single layer the way the layers are rasterized and encoded
+// by the rasterize step.
+template<class Archive> class LayerRasterizer : public Archive {
+public:
+    using Archive::Archive;
+
+    sla::EncodedRaster rasterize(const SLAPrint::PrintLayer &layer) const
+    {
+        auto rst = this->create_raster();
+        for (const ExPolygon &poly : layer.transformed_slices())
+            rst->draw(poly);
+
+        return rst->encode(this->get_encoder());
+    }
+};
+
+static void process_cube(SLAPrint &print, const char *archive_format)
+{
+    SLAFullPrintConfig fullcfg;
+
+    auto m = Model::read_from_file(TEST_DATA_DIR PATH_SEPARATOR + std::string("20mm_cube.obj"), nullptr);
+
+    fullcfg.printer_technology.setInt(ptSLA);
+    fullcfg.set("sla_archive_format", archive_format);
+    fullcfg.set("supports_enable", false);
+    fullcfg.set("pad_enable", false);
+
+    DynamicPrintConfig cfg;
+    cfg.apply(fullcfg);
+
+    print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+    print.apply(m, cfg);
+    print.process();
+}
+
+TEST_CASE("Spooled layers exported into SL1 archive match layers rasterized one by one", "[sla_archives]") {
+    SLAPrint print;
+    process_cube(print, "SL1");
+
+    const std::vector<SLAPrint::PrintLayer> &layers = print.print_layers();
+    REQUIRE(layers.size() > 2);
+
+    LayerRasterizer<SL1Archive> rasterizer(print.printer_config());
+
+    // The layers are rasterized once by the rasterize step, exporting twice
+    // reads the same spooled layers back.
+    for (int attempt = 0; attempt < 2; ++ attempt) {
+        INFO("Export " << attempt);
+        const std::string outputfname = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.sl1")).string();
+        print.export_print(outputfname, ThumbnailsList{}, "cube");
+        REQUIRE(boost::filesystem::exists(outputfname));
+
+        MZ_Archive zip;
+        REQUIRE(open_zip_reader(&zip.arch, outputfname));
+        for (size_t i = 0; i <= layers.size(); ++ i) {
+            std::string imgname = "cube" + string_printf("%.5d", int(i)) + ".png";
+            size_t      size    = 0;
+            void       *data    = mz_zip_reader_extract_file_to_heap(&zip.arch, imgname.c_str(), &size, 0);
+            if (i == layers.size()) {
+                INFO("No layer is written past the last layer");
+                CHECK(data == nullptr);
+            } else {
+                INFO("Layer " << i);
+                REQUIRE(data != nullptr);
+                sla::EncodedRaster expected = rasterizer.rasterize(layers[i]);
+                CHECK(size == expected.size());
+                CHECK((size == expected.size() && std::memcmp(data, expected.data(), size) == 0));
+            }
+            mz_free(data);
+        }
+        close_zip_reader(&zip.arch);
+        boost::filesystem::remove(outputfname);
+    }
+}
+
+static uint32_t read_uint32_le(const std::vector<uint8_t> &data, size_t pos)
+{
+    REQUIRE(pos + 4 <= data.size());
+    return uint32_t(data[pos]) | (uint32_t(data[pos + 1]) << 8) | (uint32_t(data[pos + 2]) << 16) | (uint32_t(data[pos + 3]) << 24);
+}
+
+// Number of pixels of a run length encoded Anycubic layer image.
+static size_t anycubic_rle_pixels(const uint8_t *data, size_t size)
+{
+    size_t pixels = 0;
+    for (size_t i = 0; i < size; ++ i) {
+        const uint8_t pixel = data[i] & 0xF0;
+        if (pixel == 0 || pixel == 0xF0) {
+            // Fully transparent or opaque span, the length is encoded in 12 bits.
+            REQUIRE(i + 1 < size);
+            pixels += (size_t(data[i] & 0x0F) << 8) | data[i + 1];
+            ++ i;
+        } else
+            pixels += data[i] & 0x0F;
+    }
+    return pixels;
+}
+
+TEST_CASE("Anycubic archive layer table points at the layer images", "[sla_archives]") {
+    SLAPrint print;
+    process_cube(print, "pwmx");
+
+    const std::vector<SLAPrint::PrintLayer> &layers = print.print_layers();
+    REQUIRE(layers.size() > 2);
+
+    const std::string outputfname = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.pwmx")).string();
+    print.export_print(outputfname, ThumbnailsList{}, "cube");
+
+    std::vector<uint8_t> data;
+    {
+        boost::nowide::ifstream in(outputfname, std::ios::binary);
+        REQUIRE(in.good());
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    boost::filesystem::remove(outputfname);
+
+    // Intro: 12 bytes of tag followed by the table offsets.
+    REQUIRE(data.size() > 48);
+    CHECK(std::memcmp(data.data(), "ANYCUBIC", 8) == 0);
+    const uint32_t layer_data_offset = read_uint32_le(data, 12 + 6 * 4);
+    const uint32_t image_data_offset = read_uint32_le(data, 12 + 8 * 4);
+
+    // Layer definitions: tag, payload size, layer count and a 32 bytes record per layer.
+    REQUIRE(std::memcmp(data.data() + layer_data_offset, "LAYERDEF", 8) == 0);
+    const uint32_t layer_count = read_uint32_le(data, layer_data_offset + 16);
+    REQUIRE(layer_count == layers.size());
+    CHECK(image_data_offset == layer_data_offset + 20 + 32 * layer_count);
+
+    LayerRasterizer<AnycubicSLAArchive> rasterizer(print.printer_config());
+    const size_t pixels = size_t(print.printer_config().display_pixels_x.getInt()) * size_t(print.printer_config().display_pixels_y.getInt());
+    uint32_t next_image_offset = image_data_offset;
+    for (size_t i = 0; i < layer_count; ++ i) {
+        INFO("Layer " << i);
+        const uint32_t image_offset = read_uint32_le(data, layer_data_offset + 20 + 32 * i);
+        const uint32_t image_size   = read_uint32_le(data, layer_data_offset + 20 + 32 * i + 4);
+        // The images follow the layer table back to back.
+        REQUIRE(image_offset == next_image_offset);
+        REQUIRE(size_t(image_offset) + image_size <= data.size());
+        next_image_offset += image_size;
+
+        sla::EncodedRaster expected = rasterizer.rasterize(layers[i]);
+        CHECK(image_size == expected.size());
+        CHECK((image_size == expected.size() && std::memcmp(data.data() + image_offset, expected.data(), image_size) == 0));
+        CHECK(anycubic_rle_pixels(data.data() + image_offset, image_size) == pixels);
+    }
+    CHECK(next_image_offset == data.size());
+}
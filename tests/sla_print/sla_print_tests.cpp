@@ -8,6 +8,7 @@
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
+#include <libslic3r/ClipperUtils.hpp>
 
 namespace {
 
@@ -252,6 +253,116 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
 }
 
 
+// Circular cross sections of support pillars scattered around the origin,
+// merged the way the slices of a layer are before rasterization.
+static ExPolygons support_slices(const BoundingBox &bb, size_t count, double r)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dx(bb.min.x(), bb.max.x());
+    std::uniform_real_distribution<double> dy(bb.min.y(), bb.max.y());
+
+    Polygons circles;
+    for (size_t i = 0; i < count; ++i) {
+        Polygon &circle = circles.emplace_back();
+        Point c(coord_t(dx(rng)), coord_t(dy(rng)));
+        for (size_t j = 0; j < 32; ++j) {
+            double a = 2. * PI * j / 32;
+            circle.points.emplace_back(c + Point::new_scale(r * std::cos(a), r * std::sin(a)));
+        }
+    }
+
+    return union_ex(circles);
+}
+
+static std::vector<uint8_t> raster_pixels(const sla::RasterBase &raster)
+{
+    sla::EncodedRaster enc = raster.encode([](const void *ptr, size_t w, size_t h, size_t num_components) {
+        auto px = static_cast<const uint8_t *>(ptr);
+        return sla::EncodedRaster(std::vector<uint8_t>(px, px + w * h * num_components), "raw");
+    });
+
+    auto px = static_cast<const uint8_t *>(enc.data());
+    return std::vector<uint8_t>(px, px + enc.size());
+}
+
+TEST_CASE("ScanlineRasterShouldMatchAGG", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+
+    // Supports over the whole display, a part with a hole in the middle
+    // and another one reaching over the edges of the display.
+    BoundingBox around_origin = bb;
+    around_origin.translate(- bb.center().x(), - bb.center().y());
+    ExPolygons slices = support_slices(around_origin, 500, 0.3);
+    ExPolygon part = square_with_hole(30.);
+    slices = union_ex(slices, ExPolygons{ part });
+    ExPolygon overhang = square_with_hole(20.);
+    overhang.translate(around_origin.min.x(), around_origin.max.y());
+    slices = union_ex(slices, ExPolygons{ overhang });
+
+    for (auto orientation : { sla::RasterBase::roLandscape, sla::RasterBase::roPortrait })
+        for (auto &mirror : { sla::RasterBase::NoMirror, sla::RasterBase::MirrorXY })
+            for (double gamma : { 1., 0. }) {
+                sla::RasterBase::Trafo trafo{orientation, mirror};
+                trafo.center_x = bb.center().x();
+                trafo.center_y = bb.center().y();
+
+                auto agg      = sla::create_raster_grayscale_aa(res, pixdim, gamma, trafo, sla::RasterBackend::AGG);
+                auto scanline = sla::create_raster_grayscale_aa(res, pixdim, gamma, trafo, sla::RasterBackend::Scanline);
+                for (const ExPolygon &expoly : slices) {
+                    agg->draw(expoly);
+                    scanline->draw(expoly);
+                }
+
+                std::vector<uint8_t> agg_px      = raster_pixels(*agg);
+                std::vector<uint8_t> scanline_px = raster_pixels(*scanline);
+                REQUIRE(agg_px.size() == res.pixels());
+                REQUIRE(scanline_px.size() == res.pixels());
+
+                size_t different = 0;
+                int    max_diff  = 0;
+                double agg_area = 0., scanline_area = 0.;
+                for (size_t i = 0; i < res.pixels(); ++i) {
+                    agg_area      += pixel_area(agg_px[i], pixdim);
+                    scanline_area += pixel_area(scanline_px[i], pixdim);
+                    if (int diff = std::abs(int(agg_px[i]) - int(scanline_px[i])); diff > 0) {
+                        ++different;
+                        max_diff = std::max(max_diff, diff);
+                    }
+                }
+
+                REQUIRE(agg_area > 0.);
+                REQUIRE(std::abs(agg_area - scanline_area) <= 0.001 * agg_area);
+                if (gamma > 0)
+                    // Anti-aliased edge pixels differ by the rounding of the coverage only.
+                    REQUIRE(max_diff <= 2);
+                else
+                    // Thresholding may only flip the edge pixels covered by a half.
+                    REQUIRE(different <= res.pixels() / 10000);
+            }
+}
+
+TEST_CASE("Rasterizer benchmarks", "[SLARasterOutput][.Benchmarks]") {
+    // 8K display
+    double disp_w = 218.88, disp_h = 123.12;
+    sla::Resolution res{7680, 4320};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+
+    ExPolygons slices = support_slices(bb, 20000, 0.3);
+
+    for (sla::RasterBackend backend : { sla::RasterBackend::AGG, sla::RasterBackend::Scanline }) {
+        BENCHMARK(backend == sla::RasterBackend::AGG ? "AGG, 20000 supports on 8K display" : "Scanline, 20000 supports on 8K display") {
+            auto raster = sla::create_raster_grayscale_aa(res, pixdim, 1., {}, backend);
+            for (const ExPolygon &expoly : slices)
+                raster->draw(expoly);
+            return raster->encode(sla::PPMRasterEncoder()).size();
+        };
+    }
+}
+
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
 
@@ -39,6 +39,33 @@ TEST_CASE("Raycaster - find intersections of a line and cylinder")
     REQUIRE(std::abs(out[1].first - std::sqrt(72.f)) < 0.001f);
 }
 
+TEST_CASE("Raycaster - batch of rays hits like the rays cast one by one", "[sla_raycast]")
+{
+    TriangleMesh cube = load_model("20mm_cube.obj");
+    AABBMesh emesh{cube};
+
+    // Fire a fan of rays from points inside and outside of the cube.
+    std::vector<Vec3d> sources;
+    std::vector<Vec3d> dirs;
+    Vec3d center = cube.bounding_box().center();
+    for (double offset : { -15., -5., 0., 5., 15. })
+        for (const Vec3d &dir : { Vec3d(0., 0., 1.), Vec3d(0., 1., 0.), Vec3d(-1., 0., 0.), Vec3d(Vec3d(1., 1., -1.).normalized()) }) {
+            sources.emplace_back(center + Vec3d(offset, 0.5 * offset, 0.));
+            dirs.emplace_back(dir);
+        }
+
+    std::vector<AABBMesh::hit_result> hits = emesh.query_ray_hit(sources, dirs);
+    REQUIRE(hits.size() == sources.size());
+    for (size_t i = 0; i < sources.size(); ++ i) {
+        AABBMesh::hit_result hit = emesh.query_ray_hit(sources[i], dirs[i]);
+        REQUIRE(hits[i].is_hit() == hit.is_hit());
+        if (hit.is_hit()) {
+            REQUIRE(hits[i].distance() == Approx(hit.distance()));
+            REQUIRE(hits[i].is_inside() == hit.is_inside());
+        }
+    }
+}
+
 #ifdef SLIC3R_HOLE_RAYCASTER
 // Create a simple scene with a 20mm cube and a big hole in the front wall 
 // with 5mm radius. Then shoot rays from interesting positions and see where